@@ -3,6 +3,7 @@
       "os_linux_compiler%": "gcc",
       "use_robust%": "true",
       "use_data_v1%": "false",
+      "use_zstd%": "false",
       "enable_v8%": "true",
       "enable_fast_api_calls%": "true",
       "enable_pointer_compression%": "false",
@@ -17,6 +18,7 @@
         "enable_fast_api_calls%": "<!(echo %ENABLE_FAST_API_CALLS%)",
         "enable_v8%": "<!(echo %ENABLE_V8_FUNCTIONS%)",
         "use_data_v1%": "<!(echo %LMDB_DATA_V1%)",
+        "use_zstd%": "<!(echo %LMDB_ZSTD%)",
       }
     }],
     ['OS!="win"', {
@@ -24,6 +26,7 @@
         "enable_fast_api_calls%": "<!(echo $ENABLE_FAST_API_CALLS)",
         "enable_v8%": "<!(echo $ENABLE_V8_FUNCTIONS)",
         "use_data_v1%": "<!(echo $LMDB_DATA_V1)",
+        "use_zstd%": "<!(echo $LMDB_ZSTD)",
       }
     }]
   ],
@@ -35,6 +38,7 @@
         "dependencies/lmdb/libraries/liblmdb/chacha8.c",
         "dependencies/lz4/lib/lz4.h",
         "dependencies/lz4/lib/lz4.c",
+        "dependencies/lz4/lib/lz4hc.c",
         "src/writer.cpp",
         "src/env.cpp",
         "src/compression.cpp",
@@ -105,6 +109,10 @@
         ["enable_fast_api_calls=='true'", {
           "defines": ["ENABLE_FAST_API_CALLS=1"],
         }],
+        ["use_zstd=='true'", {
+          "defines": ["USE_ZSTD"],
+          "libraries": ["-lzstd"],
+        }],
         ["use_robust=='true'", {
           "defines": ["MDB_USE_ROBUST"],
         }],
@@ -1071,6 +1071,31 @@ typedef void (MDB_txn_visible)(const void* ctx, int finished);
 int mdb_env_set_callback(MDB_env *env, MDB_check_fd *func);
 int mdb_txn_set_callback(MDB_txn *txn, MDB_txn_visible *func, void* ctx);
 int	mdb_env_set_freespace_options(MDB_env *env, unsigned int max_to_load, unsigned int max_to_retain);
+	/** @brief Add the environment to (or remove it from) the process-wide sync group.
+	 *
+	 * Overlapping syncs (#MDB_OVERLAPPINGSYNC) of the environments in the group are
+	 * coalesced into sync windows, flushing the environments that share a filesystem
+	 * with a single syncfs() (on Linux), rather than separate fdatasync() calls. This
+	 * has no effect on Windows, or with #MDB_WRITEMAP or #MDB_NOSYNC.
+	 * @param[in] env An environment handle returned by #mdb_env_create()
+	 * @param[in] enabled Non-zero to sync with the group.
+	 * @param[in] max_delay The maximum time (in microseconds) that a sync window
+	 * that this environment starts waits for other environments to join it.
+	 * @return A non-zero error value on failure and 0 on success.
+	 */
+int	mdb_env_set_group_sync(MDB_env *env, int enabled, unsigned int max_delay);
+	/** @brief Flush dirty pages through an io_uring (Linux only).
+	 *
+	 * The page writes of a commit are submitted together (followed by the sync of
+	 * the data file, for a synchronous commit), rather than with a pwritev()
+	 * (and fdatasync()) call for each run of pages. If io_uring can't be set up
+	 * (an older kernel, or it is not permitted), the usual calls are used.
+	 * @param[in] env An environment handle returned by #mdb_env_create()
+	 * @param[in] entries The number of entries in the ring, or 0 to not use io_uring.
+	 * @return A non-zero error value on failure and 0 on success. Returns
+	 * #MDB_INCOMPATIBLE if this build doesn't support io_uring.
+	 */
+int	mdb_env_set_io_uring(MDB_env *env, unsigned int entries);
 //</lmdb-js>
 
 #if MDB_RPAGE_CACHE
@@ -1510,6 +1535,50 @@ int  mdb_get(MDB_txn *txn, MDB_dbi dbi, MDB_val *key, MDB_val *data);
 int  mdb_put(MDB_txn *txn, MDB_dbi dbi, MDB_val *key, MDB_val *data,
 			    unsigned int flags);
 
+	/** @brief A callback function used to fill in reserved data.
+	 *
+	 * @param[in] data The reserved space to write the data to
+	 * @param[in] ctx An arbitrary context pointer for the callback
+	 * @return The number of bytes actually written, which must not be more
+	 * than the reserved size.
+	 */
+typedef size_t (MDB_fill_func)(MDB_val *data, void *ctx);
+
+	/** @brief Store an item, filling in the data in place.
+	 *
+	 * This reserves space for data of the given size (like #MDB_RESERVE),
+	 * calls the \b fill callback to write the data directly into the page,
+	 * and then trims the item to the size that the callback returns. This is
+	 * useful for data that is produced with a known upper bound on its size,
+	 * like compressed data, to avoid an extra copy. The item must fit on a
+	 * leaf page (not overflow pages) at the reserved size, and the reserved
+	 * size must fit in the free space of its leaf page, since splitting a page
+	 * for space that is then trimmed would leave the pages under-filled. If the
+	 * fill fails after an existing item was replaced, the transaction is
+	 * marked as failed (it can only be aborted).
+	 * @param[in] txn A transaction handle returned by #mdb_txn_begin()
+	 * @param[in] dbi A database handle returned by #mdb_dbi_open()
+	 * @param[in] key The key to store in the database
+	 * @param[in,out] data The size to reserve, on return this is set to the
+	 * stored data
+	 * @param[in] flags Special options for this operation, as for #mdb_put()
+	 * @param[in] fill The callback that writes the data
+	 * @param[in] ctx An arbitrary context pointer for the callback
+	 * @return A non-zero error value on failure and 0 on success. Some possible
+	 * errors are:
+	 * <ul>
+	 *	<li>MDB_INCOMPATIBLE - the database supports sorted duplicates, or the
+	 *		reserved size would require overflow pages.
+	 *	<li>MDB_PAGE_FULL - there isn't room for the reserved size in the leaf
+	 *		page, the item should be put with its actual size instead.
+	 *	<li>MDB_BAD_VALSIZE - the callback returned a size larger than the
+	 *		reserved size.
+	 *	<li>EINVAL - an invalid parameter was specified.
+	 * </ul>
+	 */
+int  mdb_put_fill(MDB_txn *txn, MDB_dbi dbi, MDB_val *key, MDB_val *data,
+			    unsigned int flags, MDB_fill_func *fill, void *ctx);
+
 	/** @brief Delete items from a database.
 	 *
 	 * This function removes key/data pairs from the database.
@@ -1724,6 +1793,75 @@ int  mdb_cursor_del(MDB_cursor *cursor, unsigned int flags);
 	 */
 int  mdb_cursor_count(MDB_cursor *cursor, mdb_size_t *countp);
 
+	/** @brief Find keys that split a range of a database into parts of similar size.
+	 *
+	 * This samples the branch pages of the database, descending only as far
+	 * as needed to find enough separator keys inside the range, so it is
+	 * cheap regardless of the size of the database. The returned keys are
+	 * in ascending order and strictly between \b start and \b end; fewer than
+	 * \b parts - 1 keys are returned when the range spans too few pages.
+	 * @param[in] txn A transaction handle returned by #mdb_txn_begin()
+	 * @param[in] dbi A database handle returned by #mdb_dbi_open()
+	 * @param[in] start The lowest key of the range, or NULL for the first key
+	 * @param[in] end The key the range ends before, or NULL for the last key
+	 * @param[in] parts The number of parts to split the range into
+	 * @param[out] splits An array of at least \b parts - 1 items for the split keys
+	 * @param[out] buf A buffer the split keys are copied into
+	 * @param[in] bufsize The size of \b buf
+	 * @param[out] countp Address where the number of split keys will be stored
+	 * @return A non-zero error value on failure and 0 on success. Some possible
+	 * errors are:
+	 * <ul>
+	 *	<li>EINVAL - an invalid parameter was specified.
+	 *	<li>ENOMEM - out of memory.
+	 * </ul>
+	 */
+int  mdb_range_splits(MDB_txn *txn, MDB_dbi dbi, MDB_val *start, MDB_val *end,
+	unsigned int parts, MDB_val *splits, char *buf, size_t bufsize,
+	unsigned int *countp);
+
+	/** @brief Move a cursor forward by a number of entries.
+	 *
+	 * This skips whole leaf pages at a time (by their number of keys), rather
+	 * than visiting each entry, and leaves the cursor on the entry \b n entries
+	 * after the current one, which can be retrieved with #MDB_GET_CURRENT.
+	 * This call is not valid on databases that support sorted duplicate
+	 * data items #MDB_DUPSORT.
+	 * @param[in] cursor A cursor handle returned by #mdb_cursor_open()
+	 * @param[in] n The number of entries to move forward
+	 * @param[out] skipped Address where the number of entries moved will be
+	 * stored (less than \b n if the end of the database was reached)
+	 * @return A non-zero error value on failure and 0 on success. Some possible
+	 * errors are:
+	 * <ul>
+	 *	<li>MDB_NOTFOUND - the end of the database was reached.
+	 *	<li>MDB_INCOMPATIBLE - the database supports sorted duplicates.
+	 *	<li>EINVAL - cursor is not initialized, or an invalid parameter was specified.
+	 * </ul>
+	 */
+int  mdb_cursor_skip(MDB_cursor *cursor, mdb_size_t n, mdb_size_t *skipped);
+
+	/** @brief Count the entries from the current position of a cursor to a key.
+	 *
+	 * This counts whole leaf pages at a time (by their number of keys), and
+	 * binary searches the page the range ends on, rather than visiting each
+	 * entry. The current entry is included in the count, and the cursor is left
+	 * on the first entry at or after \b end (or at the end of the database).
+	 * This call is not valid on databases that support sorted duplicate
+	 * data items #MDB_DUPSORT.
+	 * @param[in] cursor A cursor handle returned by #mdb_cursor_open()
+	 * @param[in] end The key to count up to (not included), or NULL to count
+	 * to the end of the database
+	 * @param[out] countp Address where the count will be stored
+	 * @return A non-zero error value on failure and 0 on success. Some possible
+	 * errors are:
+	 * <ul>
+	 *	<li>MDB_INCOMPATIBLE - the database supports sorted duplicates.
+	 *	<li>EINVAL - cursor is not initialized, or an invalid parameter was specified.
+	 * </ul>
+	 */
+int  mdb_cursor_count_range(MDB_cursor *cursor, MDB_val *end, mdb_size_t *countp);
+
 	/** @brief Compare two data items according to a particular database.
 	 *
 	 * This returns a comparison as if the two data items were keys in the
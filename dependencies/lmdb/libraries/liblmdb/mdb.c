@@ -1465,6 +1465,8 @@ struct MDB_txn {
 #define MDB_TXN_SPILLS		0x08		/**< txn or a parent has spilled pages */
 #define MDB_TXN_HAS_CHILD	0x10		/**< txn has an #MDB_txn.%mt_child */
 #define MDB_TXN_DIRTYNUM	0x20		/**< dirty list uses nump list */
+#define MDB_TXN_SYNC_FLUSH	0x40		/**< sync the data file with the page flush, if it can be linked */
+#define MDB_TXN_SYNCED		0x80		/**< the data file was synced with the page flush */
 	/** most operations on the txn are currently illegal */
 #define MDB_TXN_BLOCKED		(MDB_TXN_FINISHED|MDB_TXN_ERROR|MDB_TXN_HAS_CHILD)
 /** @} */
@@ -1600,6 +1602,37 @@ struct MDB_last_map {
 };
 typedef struct MDB_last_map MDB_last_map;
 /*</lmdb-js>*/
+// <lmdb-js>
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#ifdef __NR_io_uring_setup
+	/** Page flushes can be submitted to an io_uring, see #mdb_env_set_io_uring() */
+#define MDB_IO_URING	1
+#endif
+#endif
+#endif
+
+#ifdef MDB_IO_URING
+	/** An io_uring for flushing pages, used by the writer of the env. */
+typedef struct MDB_uring {
+	int		mu_fd;
+	unsigned	mu_entries;
+	unsigned	*mu_sq_head, *mu_sq_tail, *mu_sq_mask, *mu_sq_array;
+	unsigned	*mu_cq_head, *mu_cq_tail, *mu_cq_mask;
+	struct io_uring_sqe	*mu_sqes;
+	struct io_uring_cqe	*mu_cqes;
+	void	*mu_sq_ring, *mu_cq_ring;
+	size_t	mu_sq_ring_size, mu_cq_ring_size;
+	unsigned	mu_to_submit;	/**< queued entries not yet submitted */
+	unsigned	mu_inflight;	/**< submitted entries not yet completed */
+	struct iovec	*mu_iov;	/**< iovecs for all the writes of a flush */
+	unsigned	mu_iov_size;
+} MDB_uring;
+#endif
+// </lmdb-js>
+
 	/** The database environment. */
 struct MDB_env {
 	HANDLE		me_fd;		/**< The main data file */
@@ -1693,6 +1726,14 @@ struct MDB_env {
 # endif
 #endif
 	mdb_size_t me_synced_txn_id;
+	int		me_group_sync;	/**< flush overlapping syncs with the process-wide sync group */
+	unsigned int	me_group_sync_delay;	/**< microseconds to wait for other envs to join a sync window */
+	int		me_group_sync_rc;	/**< result of flushing this env in its last sync window */
+	unsigned int	me_uring_entries;	/**< size of the io_uring to flush pages with, 0 for none */
+#ifdef MDB_IO_URING
+	MDB_uring	*me_uring;	/**< io_uring for page flushes, if it could be set up */
+	int		me_uring_failed;	/**< io_uring isn't available, use pwritev */
+#endif
 #if MDB_RPAGE_CACHE
 	MDB_ID3L	me_rpages;	/**< like #mt_rpages, but global to env */
 	pthread_mutex_t	me_rpmutex;	/**< control access to #me_rpages */
@@ -3343,6 +3384,154 @@ mdb_env_sync0(MDB_env *env, int force, pgno_t numpgs)
 	return rc;
 }
 
+// <lmdb-js>
+#ifndef _WIN32
+/** Process-wide group sync. Overlapping syncs of the envs in the group are
+ * coalesced into windows, so that many envs on the same filesystem can be
+ * flushed with one syncfs() (each env that is alone on its filesystem in a
+ * window is flushed with fdatasync(), as usual). Each sync waits for a window
+ * that starts after it joins. The first env to join leads the window: it waits
+ * up to its delay for other envs to join, and then flushes all of them.
+ */
+typedef struct MDB_sync_group {
+	pthread_mutex_t	sg_mutex;
+	pthread_cond_t	sg_cond;	/**< signaled when a window is completed */
+	MDB_env	**sg_pending;	/**< envs to flush in the next window */
+	MDB_env	**sg_flushing;	/**< envs being flushed in the current window */
+	unsigned int	sg_count;	/**< number of pending envs */
+	unsigned int	sg_size;	/**< allocated size of the env lists */
+	uint64_t	sg_started;	/**< number of windows started */
+	uint64_t	sg_completed;	/**< number of windows completed */
+	int	sg_leading;	/**< a window is being collected or flushed */
+} MDB_sync_group;
+
+static MDB_sync_group mdb_sync_group = {
+	PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, NULL, NULL, 0, 0, 0, 0, 0
+};
+
+/** Flush the data file of the env in the next window of the sync group. */
+static int
+mdb_group_flush(MDB_env *env)
+{
+	MDB_sync_group *sg = &mdb_sync_group;
+	MDB_env **flushing;
+	uint64_t window;
+	unsigned int i, j, count;
+	int rc;
+
+	pthread_mutex_lock(&sg->sg_mutex);
+	/* the leader reads sg_flushing without the mutex, so the lists can't be resized until its window is done */
+	while (sg->sg_count == sg->sg_size && sg->sg_leading)
+		pthread_cond_wait(&sg->sg_cond, &sg->sg_mutex);
+	if (sg->sg_count == sg->sg_size) {
+		unsigned int size = sg->sg_size ? sg->sg_size << 1 : 16;
+		MDB_env **pending = realloc(sg->sg_pending, size * sizeof(MDB_env *));
+		flushing = pending ? realloc(sg->sg_flushing, size * sizeof(MDB_env *)) : NULL;
+		if (pending)
+			sg->sg_pending = pending;
+		if (!flushing) {
+			pthread_mutex_unlock(&sg->sg_mutex);
+			return ENOMEM;
+		}
+		sg->sg_flushing = flushing;
+		sg->sg_size = size;
+	}
+	sg->sg_pending[sg->sg_count++] = env;
+	window = sg->sg_started + 1;
+	while (sg->sg_completed < window) {
+		if (sg->sg_leading) {
+			pthread_cond_wait(&sg->sg_cond, &sg->sg_mutex);
+			continue;
+		}
+		sg->sg_leading = 1;
+		if (env->me_group_sync_delay) {
+			/* give the other envs a chance to join this window */
+			pthread_mutex_unlock(&sg->sg_mutex);
+			usleep(env->me_group_sync_delay);
+			pthread_mutex_lock(&sg->sg_mutex);
+		}
+		flushing = sg->sg_pending;
+		sg->sg_pending = sg->sg_flushing;
+		sg->sg_flushing = flushing;
+		count = sg->sg_count;
+		sg->sg_count = 0;
+		sg->sg_started++;
+		pthread_mutex_unlock(&sg->sg_mutex);
+
+		for (i = 0; i < count; i++)
+			flushing[i]->me_group_sync_rc = -1;
+		for (i = 0; i < count; i++) {
+			MDB_env *e = flushing[i];
+			if (e->me_group_sync_rc != -1)
+				continue; /* already flushed with another env on its filesystem */
+#ifdef __linux__
+			{
+				struct stat st, other;
+				int shared = 0;
+				if (fstat(e->me_fd, &st) == 0) {
+					for (j = i + 1; j < count; j++) {
+						if (flushing[j]->me_group_sync_rc == -1 &&
+								fstat(flushing[j]->me_fd, &other) == 0 && other.st_dev == st.st_dev) {
+							flushing[j]->me_group_sync_rc = -2; /* flushed by this syncfs */
+							shared = 1;
+						}
+					}
+				}
+				if (shared) {
+					rc = syncfs(e->me_fd) ? ErrCode() : 0;
+					e->me_group_sync_rc = rc;
+					for (j = i + 1; j < count; j++) {
+						if (flushing[j]->me_group_sync_rc == -2)
+							flushing[j]->me_group_sync_rc = rc;
+					}
+					continue;
+				}
+			}
+#endif
+			e->me_group_sync_rc = mdb_env_sync0(e, 1, 0);
+		}
+
+		pthread_mutex_lock(&sg->sg_mutex);
+		sg->sg_completed = sg->sg_started;
+		sg->sg_leading = 0;
+		pthread_cond_broadcast(&sg->sg_cond);
+	}
+	rc = env->me_group_sync_rc;
+	pthread_mutex_unlock(&sg->sg_mutex);
+	return rc;
+}
+#endif
+
+/** Sync the data file for an overlapping sync, in the sync group if the env is in it. */
+static int
+mdb_env_sync_data(MDB_env *env, int force, pgno_t numpgs)
+{
+#ifndef _WIN32
+	if (env->me_group_sync && !(env->me_flags & (MDB_WRITEMAP|MDB_NOSYNC|MDB_RDONLY)))
+		return mdb_group_flush(env);
+#endif
+	return mdb_env_sync0(env, force, numpgs);
+}
+
+/** Write (and sync) the meta page for an overlapping sync. In the sync group, the
+ * meta page is written without syncing, and then flushed with the group.
+ */
+static int
+mdb_env_write_sync_meta(MDB_txn *sync_txn)
+{
+#ifndef _WIN32
+	MDB_env *env = sync_txn->mt_env;
+	if (env->me_group_sync && !(env->me_flags & (MDB_WRITEMAP|MDB_NOSYNC|MDB_RDONLY))) {
+		int rc;
+		sync_txn->mt_flags |= MDB_NOMETASYNC;
+		rc = mdb_env_write_meta(sync_txn);
+		return rc ? rc : mdb_group_flush(env);
+	}
+#endif
+	return mdb_env_write_meta(sync_txn);
+}
+// </lmdb-js>
+
 int
 mdb_env_sync(MDB_env *env, int force)
 {
@@ -3376,7 +3565,7 @@ mdb_env_sync(MDB_env *env, int force)
 			sync_txn.mt_txnid = last_txn_id = m->mm_txnid;
 			sync_txn.mt_next_pgno = m->mm_last_pg + 1;
 		} while(ti->mti_txnid != last_txn_id); // avoid race condition in copying data by verifying that this is updated
-		rc = mdb_env_sync0(env, force, sync_txn.mt_next_pgno);
+		rc = mdb_env_sync_data(env, force, sync_txn.mt_next_pgno);
 
 		if (rc) {
 			if (env->me_flags & MDB_TRACK_METRICS) {
@@ -3385,7 +3574,7 @@ mdb_env_sync(MDB_env *env, int force)
 			UNLOCK_MUTEX(env->me_sync_mutex);
 			return rc;
 		}
-		rc = mdb_env_write_meta(&sync_txn);
+		rc = mdb_env_write_sync_meta(&sync_txn);
 		if (rc == 0)
 			env->me_synced_txn_id = last_txn_id;
 		//fprintf(stderr,"finished syncing txn %u, ", last_txn_id);
@@ -4534,7 +4723,167 @@ static int mdb_page_chk_checksum(MDB_env *env, MDB_page *mp, size_t size);
 static void mdb_page_set_checksum(MDB_env *env, MDB_page *mp, size_t size);
 #endif
 
+// <lmdb-js>
+#ifdef MDB_IO_URING
+/** Close an io_uring. */
+static void
+mdb_uring_close(MDB_uring *ring)
+{
+	if (ring->mu_sqes)
+		munmap(ring->mu_sqes, ring->mu_entries * sizeof(struct io_uring_sqe));
+	if (ring->mu_cq_ring && ring->mu_cq_ring != ring->mu_sq_ring)
+		munmap(ring->mu_cq_ring, ring->mu_cq_ring_size);
+	if (ring->mu_sq_ring)
+		munmap(ring->mu_sq_ring, ring->mu_sq_ring_size);
+	if (ring->mu_fd >= 0)
+		close(ring->mu_fd);
+	free(ring->mu_iov);
+	free(ring);
+}
+
+/** Set up an io_uring for page flushes.
+ * @return The ring, or NULL if io_uring isn't available (or permitted).
+ */
+static MDB_uring *
+mdb_uring_open(unsigned entries)
+{
+	struct io_uring_params params;
+	MDB_uring *ring = calloc(1, sizeof(MDB_uring));
+	char *sq, *cq;
+	if (!ring)
+		return NULL;
+	memset(&params, 0, sizeof(params));
+	ring->mu_fd = syscall(__NR_io_uring_setup, entries, &params);
+	if (ring->mu_fd < 0)
+		goto fail;
+	ring->mu_entries = params.sq_entries;
+	ring->mu_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	ring->mu_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+#ifdef IORING_FEAT_SINGLE_MMAP
+	if (params.features & IORING_FEAT_SINGLE_MMAP) {
+		if (ring->mu_cq_ring_size > ring->mu_sq_ring_size)
+			ring->mu_sq_ring_size = ring->mu_cq_ring_size;
+		ring->mu_cq_ring_size = ring->mu_sq_ring_size;
+	}
+#endif
+	ring->mu_sq_ring = mmap(NULL, ring->mu_sq_ring_size, PROT_READ|PROT_WRITE,
+		MAP_SHARED|MAP_POPULATE, ring->mu_fd, IORING_OFF_SQ_RING);
+	if (ring->mu_sq_ring == MAP_FAILED) {
+		ring->mu_sq_ring = NULL;
+		goto fail;
+	}
+#ifdef IORING_FEAT_SINGLE_MMAP
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+		ring->mu_cq_ring = ring->mu_sq_ring;
+	else
+#endif
+	{
+		ring->mu_cq_ring = mmap(NULL, ring->mu_cq_ring_size, PROT_READ|PROT_WRITE,
+			MAP_SHARED|MAP_POPULATE, ring->mu_fd, IORING_OFF_CQ_RING);
+		if (ring->mu_cq_ring == MAP_FAILED) {
+			ring->mu_cq_ring = NULL;
+			goto fail;
+		}
+	}
+	ring->mu_sqes = mmap(NULL, params.sq_entries * sizeof(struct io_uring_sqe), PROT_READ|PROT_WRITE,
+		MAP_SHARED|MAP_POPULATE, ring->mu_fd, IORING_OFF_SQES);
+	if (ring->mu_sqes == MAP_FAILED) {
+		ring->mu_sqes = NULL;
+		goto fail;
+	}
+	sq = ring->mu_sq_ring;
+	ring->mu_sq_head = (unsigned *)(sq + params.sq_off.head);
+	ring->mu_sq_tail = (unsigned *)(sq + params.sq_off.tail);
+	ring->mu_sq_mask = (unsigned *)(sq + params.sq_off.ring_mask);
+	ring->mu_sq_array = (unsigned *)(sq + params.sq_off.array);
+	cq = ring->mu_cq_ring;
+	ring->mu_cq_head = (unsigned *)(cq + params.cq_off.head);
+	ring->mu_cq_tail = (unsigned *)(cq + params.cq_off.tail);
+	ring->mu_cq_mask = (unsigned *)(cq + params.cq_off.ring_mask);
+	ring->mu_cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+	return ring;
+fail:
+	mdb_uring_close(ring);
+	return NULL;
+}
+
+/** Submit the queued entries of the ring, and reap completions.
+ * @param[in] ring The ring.
+ * @param[in] all Wait for all of the entries to complete, otherwise for at least one.
+ * @return 0 if all the reaped entries succeeded, otherwise the first error.
+ */
+static int
+mdb_uring_wait(MDB_uring *ring, int all)
+{
+	int rc = 0, ret;
+	unsigned head;
+	while (ring->mu_to_submit || ring->mu_inflight) {
+		ret = syscall(__NR_io_uring_enter, ring->mu_fd, ring->mu_to_submit,
+			all ? ring->mu_to_submit + ring->mu_inflight : 1, IORING_ENTER_GETEVENTS, NULL, 0);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			return ErrCode();
+		}
+		ring->mu_to_submit -= ret;
+		ring->mu_inflight += ret;
+		head = *ring->mu_cq_head;
+		while (head != __atomic_load_n(ring->mu_cq_tail, __ATOMIC_ACQUIRE)) {
+			struct io_uring_cqe *cqe = &ring->mu_cqes[head & *ring->mu_cq_mask];
+			/* user_data is the expected size of a write (and 0 for the sync) */
+			if (cqe->res < 0 ? 1 : (uint64_t)cqe->res != cqe->user_data) {
+				if (!rc)
+					rc = cqe->res < 0 ? -cqe->res : EIO;
+			}
+			head++;
+			ring->mu_inflight--;
+		}
+		__atomic_store_n(ring->mu_cq_head, head, __ATOMIC_RELEASE);
+		if (!all)
+			break;
+	}
+	return rc;
+}
+
+/** Queue an operation on the ring, making room if the ring is full.
+ * @return 0 on success, or the error of a previous entry that was reaped.
+ */
+static int
+mdb_uring_queue(MDB_uring *ring, int opcode, int fd, struct iovec *iov, unsigned n,
+	MDB_OFF_T pos, size_t size, unsigned flags)
+{
+	struct io_uring_sqe *sqe;
+	unsigned tail, index;
+	int rc;
+	while (ring->mu_to_submit + ring->mu_inflight >= ring->mu_entries) {
+		if ((rc = mdb_uring_wait(ring, 0)))
+			return rc;
+	}
+	tail = *ring->mu_sq_tail;
+	index = tail & *ring->mu_sq_mask;
+	sqe = &ring->mu_sqes[index];
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = opcode;
+	sqe->fd = fd;
+	sqe->addr = (uint64_t)(uintptr_t)iov;
+	sqe->len = n;
+	sqe->off = pos;
+	sqe->user_data = size;
+	if (opcode == IORING_OP_FSYNC) {
+		sqe->fsync_flags = flags;
+		sqe->flags = IOSQE_IO_DRAIN; /* after all the writes */
+	}
+	ring->mu_sq_array[index] = index;
+	__atomic_store_n(ring->mu_sq_tail, tail + 1, __ATOMIC_RELEASE);
+	ring->mu_to_submit++;
+	return 0;
+}
+#endif
+// </lmdb-js>
+
 /** Flush (some) dirty pages to the map, after clearing their dirty flag.
+ * With an io_uring, all the writes are queued and submitted together, followed by
+ * the sync of the data file if the commit requested it (#MDB_TXN_SYNC_FLUSH).
  * @param[in] txn the transaction that's being committed
  * @param[in] keep number of initial pages in dirty_list to keep dirty.
  * @return 0 on success, non-zero on failure.
@@ -4560,7 +4909,7 @@ mdb_page_flush(MDB_txn *txn, int keep)
 	MDB_page	*wdp;
 	HANDLE fd = (txn->mt_flags & MDB_NOSYNC) ? env->me_fd : env->me_ovfd;
 #else
-	struct iovec iov[MDB_COMMIT_PAGES];
+	struct iovec iov_batch[MDB_COMMIT_PAGES], *iov = iov_batch;
 	HANDLE fd = env->me_fd;
 #endif
 	ssize_t		wsize = 0, wres;
@@ -4592,6 +4941,30 @@ mdb_page_flush(MDB_txn *txn, int keep)
 		}
 	}
 	txn->mt_flags |= MDB_TXN_DIRTYNUM;
+	txn->mt_flags &= ~MDB_TXN_SYNCED;
+#ifdef MDB_IO_URING
+	MDB_uring *ring = NULL;
+	if (env->me_uring_entries && !env->me_uring_failed) {
+		if (!env->me_uring && !(env->me_uring = mdb_uring_open(env->me_uring_entries)))
+			env->me_uring_failed = 1; /* not available, use pwritev */
+		ring = env->me_uring;
+	}
+	if (ring) {
+		/* the writes are all in flight together, so each needs its own iovecs */
+		if (ring->mu_iov_size < (unsigned)(pagecount - keep)) {
+			unsigned size = (pagecount - keep) + (pagecount >> 1) + 16;
+			struct iovec *ring_iov = realloc(ring->mu_iov, size * sizeof(struct iovec));
+			if (ring_iov) {
+				ring->mu_iov = ring_iov;
+				ring->mu_iov_size = size;
+			}
+		}
+		if (ring->mu_iov_size >= (unsigned)(pagecount - keep))
+			iov = ring->mu_iov;
+		else
+			ring = NULL;
+	}
+#endif
 	/* <lmdb-js addition> */
 	n = 0;
 	
@@ -4714,6 +5087,16 @@ retry_write:
 					rc = 0;
 				}
 #else /* _WIN32 */
+#ifdef MDB_IO_URING
+				if (ring) {
+					if ((rc = mdb_uring_queue(ring, IORING_OP_WRITEV, fd, iov, n, wpos, wsize, 0))) {
+						mdb_uring_wait(ring, 1);
+						return rc;
+					}
+					iov += n; /* these are in flight, the next writes use the following iovecs */
+					wres = wsize;
+				} else
+#endif
 #ifdef MDB_USE_PWRITEV
 				wres = pwritev(fd, iov, n, wpos);
 #else
@@ -4763,10 +5146,19 @@ retry_seek:
 		}
 		if (env->me_encfunc) {
 			MDB_page *encp = mdb_page_malloc(txn, nump, 0);
-			if (!encp)
+			if (!encp) {
+#ifdef MDB_IO_URING
+				if (ring)
+					mdb_uring_wait(ring, 1);
+#endif
 				return ENOMEM;
+			}
 			if (mdb_page_encrypt(env, dp, encp, size)) {
 				mdb_dpage_free_n(env, encp, nump);
+#ifdef MDB_IO_URING
+				if (ring)
+					mdb_uring_wait(ring, 1);
+#endif
 				return MDB_CRYPTO_FAIL;
 			}
 			mdb_dpage_free_n(env, dp, nump);
@@ -4790,6 +5182,26 @@ retry_seek:
 		txn->mt_last_pgno = pgno;
 #endif
 
+#ifdef MDB_IO_URING
+	if (ring) {
+		int wait_rc;
+		rc = 0;
+		if (txn->mt_flags & MDB_TXN_SYNC_FLUSH) {
+			unsigned fsync_flags = IORING_FSYNC_DATASYNC;
+#ifdef BROKEN_FDATASYNC
+			if (env->me_flags & MDB_FSYNCONLY)
+				fsync_flags = 0;
+#endif
+			rc = mdb_uring_queue(ring, IORING_OP_FSYNC, fd, NULL, 0, 0, 0, fsync_flags);
+		}
+		wait_rc = mdb_uring_wait(ring, 1);
+		if (rc || (rc = wait_rc))
+			return rc;
+		if (txn->mt_flags & MDB_TXN_SYNC_FLUSH)
+			txn->mt_flags |= MDB_TXN_SYNCED;
+	}
+#endif
+
 	/* MIPS has cache coherency issues, this is a no-op everywhere else
 	 * Note: for any size >= on-chip cache size, entire on-chip cache is
 	 * flushed.
@@ -5067,7 +5479,12 @@ mdb_txn_commit(MDB_txn *txn)
 	mdb_audit(txn);
 #endif
 	int dirty_pages = txn->mt_u.dirty_list[0].mid;
-	if ((rc = mdb_page_flush(txn, 0)))
+	/* with an io_uring, the sync can be submitted along with the page writes */
+	if (!F_ISSET(txn->mt_flags, MDB_TXN_NOSYNC) && !(env->me_flags & MDB_NOSYNC))
+		txn->mt_flags |= MDB_TXN_SYNC_FLUSH;
+	rc = mdb_page_flush(txn, 0);
+	txn->mt_flags &= ~MDB_TXN_SYNC_FLUSH;
+	if (rc)
 		goto fail;
 	if ((unsigned)txn->mt_loose_count < txn->mt_u.dirty_list[0].mid) {
 		last_error = malloc(100);
@@ -5075,7 +5492,7 @@ mdb_txn_commit(MDB_txn *txn)
 		rc = MDB_PROBLEM; /* mt_loose_pgs does not match dirty_list */
 		goto fail;
 	}
-	if (!F_ISSET(txn->mt_flags, MDB_TXN_NOSYNC) &&
+	if (!F_ISSET(txn->mt_flags, MDB_TXN_NOSYNC) && !(txn->mt_flags & MDB_TXN_SYNCED) &&
 		(rc = mdb_env_sync0(env, 0, txn->mt_next_pgno)))
 		goto fail;
 
@@ -5154,12 +5571,12 @@ done:
 				sync_txn.mt_next_pgno = m->mm_last_pg + 1;
 			} while(ti->mti_txnid != txn_id); // avoid race condition in copying data by verifying that this is updated
 
-			rc = mdb_env_sync0(env, 0, m->mm_last_pg);
+			rc = mdb_env_sync_data(env, 0, m->mm_last_pg);
 			if (rc) {
 				UNLOCK_MUTEX(env->me_sync_mutex);
 				return rc;
 			}
-			rc = mdb_env_write_meta(&sync_txn);
+			rc = mdb_env_write_sync_meta(&sync_txn);
 			if (rc == 0)
 				env->me_synced_txn_id = sync_txn.mt_txnid;
 			if (env->me_flags & MDB_TRACK_METRICS) {
@@ -7042,6 +7459,12 @@ mdb_env_close_active(MDB_env *env, int excl)
 	free(env->me_path);
 	free(env->me_dirty_list);
 	free(env->me_dirty_nump);
+#ifdef MDB_IO_URING
+	if (env->me_uring) {
+		mdb_uring_close(env->me_uring);
+		env->me_uring = NULL;
+	}
+#endif
 #if MDB_RPAGE_CACHE
 	if (MDB_REMAPPING(env->me_flags)) {
 	if (env->me_txn0 && env->me_txn0->mt_rpages)
@@ -7308,7 +7731,31 @@ mdb_cmp_memnr(const MDB_val *a, const MDB_val *b)
 	return len_diff<0 ? -1 : len_diff;
 }
 
+/** Number of interpolation probes to make in a page of integer keys,
+ * before falling back to binary search.
+ */
+#define MDB_INTERPOLATE_PROBES	2
+/** Minimum number of keys in the search range for interpolation. */
+#define MDB_INTERPOLATE_MIN	8
+
+/** Read an (unaligned) integer key, for interpolation search. */
+static mdb_size_t
+mdb_int_key(const void *data, size_t size)
+{
+	if (size == sizeof(unsigned int)) {
+		unsigned int u;
+		memcpy(&u, data, sizeof(u));
+		return u;
+	} else {
+		mdb_size_t u;
+		memcpy(&u, data, sizeof(u));
+		return u;
+	}
+}
+
 /** Search for key within a page, using binary search.
+ * With integer keys, the search starts with interpolation, since
+ * integer keys (like sequence numbers) are often evenly distributed.
  * Returns the smallest entry larger or equal to the key.
  * If exactp is non-null, stores whether the found entry was an exact match
  * in *exactp (1 or 0).
@@ -7347,6 +7794,52 @@ mdb_node_search(MDB_cursor *mc, MDB_val *key, int *exactp)
 			cmp = mdb_cmp_int;
 	}
 
+	/* Estimate the position of the key from the first and last keys of the
+	 * range, and narrow the range with a few probes. Skewed keys are left
+	 * to the binary search that follows. Each probe leaves i, rc, and node
+	 * as a binary search step would, so the result is the same.
+	 */
+	if ((cmp == mdb_cmp_cint || cmp == mdb_cmp_int || cmp == mdb_cmp_long) &&
+		(key->mv_size == sizeof(unsigned int) || key->mv_size == sizeof(mdb_size_t))) {
+		mdb_size_t target = mdb_int_key(key->mv_data, key->mv_size), lowKey, highKey, probe;
+		int probes;
+		for (probes = 0; probes < MDB_INTERPOLATE_PROBES && high - low >= MDB_INTERPOLATE_MIN; probes++) {
+			if (IS_LEAF2(mp)) {
+				if (mc->mc_db->md_pad != key->mv_size)
+					break;
+				lowKey = mdb_int_key(LEAF2KEY(mp, low, key->mv_size), key->mv_size);
+				highKey = mdb_int_key(LEAF2KEY(mp, high, key->mv_size), key->mv_size);
+			} else {
+				if (NODEKSZ(NODEPTR(mp, low)) != key->mv_size || NODEKSZ(NODEPTR(mp, high)) != key->mv_size)
+					break;
+				lowKey = mdb_int_key(NODEKEY(NODEPTR(mp, low)), key->mv_size);
+				highKey = mdb_int_key(NODEKEY(NODEPTR(mp, high)), key->mv_size);
+			}
+			if (target <= lowKey || target >= highKey)
+				break;
+			i = low + (unsigned int)((double)(target - lowKey) * (high - low) / (double)(highKey - lowKey));
+			if (IS_LEAF2(mp)) {
+				node = NODEPTR(mp, 0);	/* fake */
+				probe = mdb_int_key(LEAF2KEY(mp, i, key->mv_size), key->mv_size);
+			} else {
+				node = NODEPTR(mp, i);
+				probe = mdb_int_key(NODEKEY(node), key->mv_size);
+			}
+			if (target == probe) {
+				rc = 0;
+				low = high + 1; /* found, skip the binary search */
+				break;
+			}
+			if (target > probe) {
+				rc = 1;
+				low = i + 1;
+			} else {
+				rc = -1;
+				high = i - 1;
+			}
+		}
+	}
+
 	if (IS_LEAF2(mp)) {
 		nodekey.mv_size = mc->mc_db->md_pad;
 		node = NODEPTR(mp, 0);	/* fake */
@@ -10417,6 +10910,120 @@ mdb_cursor_count(MDB_cursor *mc, mdb_size_t *countp)
 	return MDB_SUCCESS;
 }
 
+/** Check that a cursor can be moved a page at a time by #mdb_cursor_skip()
+ * and #mdb_cursor_count_range(). Sorted duplicates live in sub-databases,
+ * so their entries aren't all on the leaf pages of the main tree.
+ */
+static int
+mdb_cursor_pageable(MDB_cursor *mc)
+{
+	if (mc->mc_txn->mt_flags & MDB_TXN_BLOCKED)
+		return MDB_BAD_TXN;
+	if (mc->mc_db->md_flags & MDB_DUPSORT)
+		return MDB_INCOMPATIBLE;
+	if (!(mc->mc_flags & C_INITIALIZED) || (mc->mc_flags & C_DEL))
+		return EINVAL;
+	if (!mc->mc_snum || (mc->mc_flags & C_EOF))
+		return MDB_NOTFOUND;
+	return MDB_SUCCESS;
+}
+
+int
+mdb_cursor_skip(MDB_cursor *mc, mdb_size_t n, mdb_size_t *skipped)
+{
+	MDB_page	*mp;
+	mdb_size_t	 left, done = 0;
+	int rc;
+
+	if (mc == NULL)
+		return EINVAL;
+	if ((rc = mdb_cursor_pageable(mc)) != MDB_SUCCESS)
+		goto done;
+
+	/* Skip whole leaf pages at a time, by their number of keys */
+	while (done < n) {
+		mp = mc->mc_pg[mc->mc_top];
+		left = NUMKEYS(mp) - mc->mc_ki[mc->mc_top];
+		if (n - done < left) {
+			mc->mc_ki[mc->mc_top] += n - done;
+			done = n;
+			break;
+		}
+		if ((rc = mdb_cursor_sibling(mc, 1)) != MDB_SUCCESS) {
+			if (rc == MDB_NOTFOUND) {
+				mc->mc_ki[mc->mc_top] = NUMKEYS(mp) - 1;
+				mc->mc_flags |= C_EOF;
+			}
+			done += left - 1;
+			break;
+		}
+		done += left;
+	}
+done:
+	if (skipped)
+		*skipped = done;
+	return rc;
+}
+
+int
+mdb_cursor_count_range(MDB_cursor *mc, MDB_val *end, mdb_size_t *countp)
+{
+	MDB_page	*mp;
+	MDB_node	*node;
+	MDB_val		 key;
+	mdb_size_t	 count = 0;
+	unsigned int nkeys, low, high, middle;
+	int rc;
+
+	if (mc == NULL || countp == NULL)
+		return EINVAL;
+	if ((rc = mdb_cursor_pageable(mc)) != MDB_SUCCESS) {
+		if (rc == MDB_NOTFOUND) {
+			*countp = 0;
+			rc = MDB_SUCCESS;
+		}
+		return rc;
+	}
+
+	for (;;) {
+		mp = mc->mc_pg[mc->mc_top];
+		nkeys = NUMKEYS(mp);
+		if (end) {
+			node = NODEPTR(mp, nkeys - 1);
+			MDB_GET_KEY2(node, key);
+			if (mc->mc_dbx->md_cmp(&key, end) >= 0) {
+				/* The end is on this page, binary search for the first key at or after it */
+				low = mc->mc_ki[mc->mc_top];
+				high = nkeys - 1;
+				while (low < high) {
+					middle = (low + high) >> 1;
+					node = NODEPTR(mp, middle);
+					MDB_GET_KEY2(node, key);
+					if (mc->mc_dbx->md_cmp(&key, end) >= 0)
+						high = middle;
+					else
+						low = middle + 1;
+				}
+				count += low - mc->mc_ki[mc->mc_top];
+				mc->mc_ki[mc->mc_top] = low;
+				break;
+			}
+		}
+		/* The whole rest of the page is in the range */
+		count += nkeys - mc->mc_ki[mc->mc_top];
+		if ((rc = mdb_cursor_sibling(mc, 1)) != MDB_SUCCESS) {
+			if (rc == MDB_NOTFOUND) {
+				mc->mc_ki[mc->mc_top] = nkeys - 1;
+				mc->mc_flags |= C_EOF;
+				rc = MDB_SUCCESS;
+			}
+			break;
+		}
+	}
+	*countp = count;
+	return rc;
+}
+
 void
 mdb_cursor_close(MDB_cursor *mc)
 {
@@ -11779,6 +12386,130 @@ mdb_put(MDB_txn *txn, MDB_dbi dbi,
 	return rc;
 }
 
+/** Shrink the data of the node the cursor is on, in place.
+ * The bytes of the nodes below it on the page are moved up to close the gap.
+ * @param[in] mc The cursor, on a node in a dirty leaf page.
+ * @param[in] size The new size of the data, no larger than the current size.
+ * @return 0 on success, non-zero on failure.
+ */
+static int
+mdb_node_trim(MDB_cursor *mc, size_t size)
+{
+	MDB_page	*mp = mc->mc_pg[mc->mc_top];
+	indx_t		 indx = mc->mc_ki[mc->mc_top];
+	MDB_node	*node;
+	indx_t		 ptr, i, numkeys;
+	size_t		 osize, len;
+	int			 delta;
+	char		*base;
+
+	if (IS_LEAF2(mp))
+		return MDB_INCOMPATIBLE;
+	node = NODEPTR(mp, indx);
+	if (node->mn_flags & (F_SUBDATA|F_DUPDATA))
+		return MDB_INCOMPATIBLE;
+	osize = NODEDSZ(node);
+	if (size > osize)
+		return MDB_BAD_VALSIZE;
+	if (F_ISSET(node->mn_flags, F_BIGDATA)) {
+		/* An existing overflow page was reused, just like a put of
+		 * smaller data, we don't bother shrinking the overflow pages.
+		 */
+		SETDSZ(node, size);
+		return MDB_SUCCESS;
+	}
+	/* Node sizes are 2-byte aligned */
+	delta = EVEN(NODESIZE + node->mn_ksize + osize) -
+		EVEN(NODESIZE + node->mn_ksize + size);
+	if (delta) {
+		ptr = mp->mp_ptrs[indx];
+		numkeys = NUMKEYS(mp);
+		for (i = 0; i < numkeys; i++) {
+			if (mp->mp_ptrs[i] <= ptr)
+				mp->mp_ptrs[i] += delta;
+		}
+		base = (char *)mp + mp->mp_upper + PAGEBASE;
+		len = ptr - mp->mp_upper + NODESIZE + node->mn_ksize + size;
+		memmove(base + delta, base, len);
+		mp->mp_upper += delta;
+		node = NODEPTR(mp, indx);
+	}
+	SETDSZ(node, size);
+	return MDB_SUCCESS;
+}
+
+int
+mdb_put_fill(MDB_txn *txn, MDB_dbi dbi,
+	MDB_val *key, MDB_val *data, unsigned int flags,
+	MDB_fill_func *fill, void *ctx)
+{
+	MDB_cursor mc;
+	MDB_xcursor mx;
+	MDB_node *node;
+	size_t size;
+	int rc, exact = 0;
+
+	if (!key || !data || !fill || !TXN_DBI_EXIST(txn, dbi, DB_USRVALID))
+		return EINVAL;
+
+	if (flags & ~(MDB_NOOVERWRITE|MDB_APPEND))
+		return EINVAL;
+
+	if (txn->mt_flags & (MDB_TXN_RDONLY|MDB_TXN_BLOCKED))
+		return (txn->mt_flags & MDB_TXN_RDONLY) ? EACCES : MDB_BAD_TXN;
+
+	/* The reserved space has to be in the leaf node to be trimmed */
+	if ((txn->mt_dbs[dbi].md_flags & MDB_DUPSORT) ||
+		LEAFSIZE(key, data) > txn->mt_env->me_nodemax)
+		return MDB_INCOMPATIBLE;
+
+	mdb_cursor_init(&mc, txn, dbi, &mx);
+	mc.mc_next = txn->mt_cursors[dbi];
+	txn->mt_cursors[dbi] = &mc;
+	if (!(flags & MDB_APPEND)) {
+		/* Find the leaf the item goes in, and don't reserve space that would split it, since
+		 * the page would be left under-filled once the item is trimmed.
+		 */
+		MDB_val k = *key;
+		rc = mdb_cursor_set(&mc, &k, NULL, MDB_SET, &exact);
+		if (rc == MDB_SUCCESS || (rc == MDB_NOTFOUND && mc.mc_snum)) {
+			MDB_page *mp = mc.mc_pg[mc.mc_top];
+			size_t needed = EVEN(LEAFSIZE(key, data));
+			if (exact) {
+				node = NODEPTR(mp, mc.mc_ki[mc.mc_top]);
+				size = EVEN(NODESIZE + NODEKSZ(node) +
+					(F_ISSET(node->mn_flags, F_BIGDATA) ? sizeof(pgno_t) : NODEDSZ(node)));
+				needed = needed > size ? needed - size : 0;
+			} else
+				needed += sizeof(indx_t);
+			rc = needed > SIZELEFT(mp) ? MDB_PAGE_FULL : MDB_SUCCESS;
+		} else if (rc == MDB_NOTFOUND)
+			rc = MDB_SUCCESS; /* empty database */
+		if (rc)
+			goto done;
+	}
+	rc = mdb_cursor_put(&mc, key, data, flags | MDB_RESERVE);
+	if (rc == MDB_SUCCESS) {
+		size = fill(data, ctx);
+		rc = mdb_node_trim(&mc, size);
+		if (rc == MDB_SUCCESS) {
+			node = NODEPTR(mc.mc_pg[mc.mc_top], mc.mc_ki[mc.mc_top]);
+			if (!F_ISSET(node->mn_flags, F_BIGDATA))
+				data->mv_data = NODEDATA(node);
+			data->mv_size = size;
+		} else if (exact) {
+			/* the previous value was already replaced, so the txn can't be committed */
+			txn->mt_flags |= MDB_TXN_ERROR;
+		} else {
+			/* don't leave the reserved (unfilled) space behind */
+			mdb_cursor_del(&mc, 0);
+		}
+	}
+done:
+	txn->mt_cursors[dbi] = mc.mc_next;
+	return rc;
+}
+
 #ifndef MDB_WBUF
 #define MDB_WBUF	(1024*1024)
 #endif
@@ -12412,6 +13143,29 @@ mdb_env_set_callback(MDB_env *env, MDB_check_fd *func)
 	return MDB_SUCCESS;
 }
 
+int ESECT
+mdb_env_set_group_sync(MDB_env *env, int enabled, unsigned int max_delay)
+{
+	if (!env)
+		return EINVAL;
+	env->me_group_sync = enabled;
+	env->me_group_sync_delay = max_delay;
+	return MDB_SUCCESS;
+}
+
+int ESECT
+mdb_env_set_io_uring(MDB_env *env, unsigned int entries)
+{
+	if (!env)
+		return EINVAL;
+#ifdef MDB_IO_URING
+	env->me_uring_entries = entries;
+	return MDB_SUCCESS;
+#else
+	return entries ? MDB_INCOMPATIBLE : MDB_SUCCESS;
+#endif
+}
+
 int ESECT
 mdb_env_set_freespace_options(MDB_env *env, unsigned int max_to_load, unsigned int max_to_retain)
 {
@@ -12703,6 +13457,171 @@ mdb_stat(MDB_txn *txn, MDB_dbi dbi, MDB_stat *arg)
 	return mdb_stat0(txn->mt_env, &txn->mt_dbs[dbi], arg);
 }
 
+/** Most pages of one level that #mdb_range_splits() will read */
+#define MDB_SPLIT_MAX_PAGES	256
+
+/** Find the span of nodes in a page that may hold keys in [start, end).
+ * Node 0 of a branch page covers everything below its right sibling.
+ * @return the number of nodes in the span.
+ */
+static unsigned int
+mdb_split_span(MDB_page *mp, MDB_cmp_func *cmp, MDB_val *start, MDB_val *end,
+	unsigned int *first)
+{
+	unsigned int i, last, nkeys = NUMKEYS(mp);
+	MDB_node *node;
+	MDB_val key;
+
+	*first = 0;
+	last = nkeys;
+	for (i = IS_LEAF(mp) ? 0 : 1; i < nkeys; i++) {
+		node = NODEPTR(mp, i);
+		key.mv_size = NODEKSZ(node);
+		key.mv_data = NODEKEY(node);
+		if (start && cmp(&key, start) <= 0)
+			*first = i;
+		if (end && cmp(&key, end) >= 0) {
+			last = i;
+			break;
+		}
+	}
+	return last > *first ? last - *first : 0;
+}
+
+int
+mdb_range_splits(MDB_txn *txn, MDB_dbi dbi, MDB_val *start, MDB_val *end,
+	unsigned int parts, MDB_val *splits, char *buf, size_t bufsize,
+	unsigned int *countp)
+{
+	MDB_cursor mc;
+	MDB_xcursor mx;
+	MDB_cmp_func *cmp;
+	MDB_page **pages, **next, **tmp, **held = NULL;
+	MDB_val *lower, *nlower, *vtmp, *found = NULL, key;
+	MDB_node *node;
+	unsigned int i, j, first, span, total, npages, nnext, nheld = 0, nfound, prev = 0;
+	int rc;
+
+	if (!splits || !buf || !countp || !TXN_DBI_EXIST(txn, dbi, DB_USRVALID))
+		return EINVAL;
+
+	if (txn->mt_flags & MDB_TXN_BLOCKED)
+		return MDB_BAD_TXN;
+
+	*countp = 0;
+	if (parts < 2)
+		return MDB_SUCCESS;
+
+	mdb_cursor_init(&mc, txn, dbi, &mx);
+	rc = mdb_page_search(&mc, NULL, MDB_PS_ROOTONLY);
+	if (rc)
+		return rc == MDB_NOTFOUND ? MDB_SUCCESS : rc;
+	cmp = mc.mc_dbx->md_cmp;
+
+	/* Two page lists per level, each page paired with the lowest key it may hold */
+	pages = malloc(MDB_SPLIT_MAX_PAGES * 2 * (sizeof(MDB_page *) + sizeof(MDB_val)));
+	if (!pages) {
+		MDB_CURSOR_UNREF(&mc, 1);
+		return ENOMEM;
+	}
+	next = pages + MDB_SPLIT_MAX_PAGES;
+	lower = (MDB_val *)(next + MDB_SPLIT_MAX_PAGES);
+	nlower = lower + MDB_SPLIT_MAX_PAGES;
+	pages[0] = mc.mc_pg[0];
+	lower[0].mv_size = 0;
+	lower[0].mv_data = NULL;
+	npages = 1;
+
+	/* Descend breadth-first until a level has enough separators in range */
+	for (;;) {
+		total = 0;
+		for (i = 0; i < npages; i++)
+			total += mdb_split_span(pages[i], cmp, start, end, &first);
+		if (total >= parts || IS_LEAF(pages[0]) || total > MDB_SPLIT_MAX_PAGES)
+			break;
+		tmp = realloc(held, (nheld + total) * sizeof(MDB_page *));
+		if (!tmp) {
+			rc = ENOMEM;
+			goto done;
+		}
+		held = tmp;
+		nnext = 0;
+		for (i = 0; i < npages; i++) {
+			span = mdb_split_span(pages[i], cmp, start, end, &first);
+			for (j = first; j < first + span; j++) {
+				node = NODEPTR(pages[i], j);
+				if ((rc = MDB_PAGE_GET(&mc, NODEPGNO(node), 1, &next[nnext])))
+					goto done;
+				held[nheld++] = next[nnext];
+				if (j) {
+					nlower[nnext].mv_size = NODEKSZ(node);
+					nlower[nnext].mv_data = NODEKEY(node);
+				} else
+					nlower[nnext] = lower[i];
+				nnext++;
+			}
+		}
+		if (!nnext)
+			goto done;
+		tmp = pages; pages = next; next = tmp;
+		vtmp = lower; lower = nlower; nlower = vtmp;
+		npages = nnext;
+	}
+
+	/* Collect the keys strictly inside (start, end), in order */
+	found = malloc((total + npages) * sizeof(MDB_val));
+	if (!found) {
+		rc = ENOMEM;
+		goto done;
+	}
+	nfound = 0;
+	for (i = 0; i < npages; i++) {
+		span = mdb_split_span(pages[i], cmp, start, end, &first);
+		for (j = first; j < first + span; j++) {
+			if (j) {
+				node = NODEPTR(pages[i], j);
+				key.mv_size = NODEKSZ(node);
+				key.mv_data = NODEKEY(node);
+			} else if (IS_LEAF(pages[i])) {
+				node = NODEPTR(pages[i], 0);
+				key.mv_size = NODEKSZ(node);
+				key.mv_data = NODEKEY(node);
+			} else
+				key = lower[i];
+			if (!key.mv_size || (start && cmp(&key, start) <= 0) ||
+				(nfound && cmp(&key, &found[nfound - 1]) <= 0))
+				continue;
+			found[nfound++] = key;
+		}
+	}
+
+	/* Pick evenly spaced separators and copy them out of the map */
+	for (i = 1; i < parts && *countp < nfound; i++) {
+		j = (unsigned int)((mdb_size_t)i * nfound / parts);
+		if (*countp && j <= prev)
+			continue;
+		prev = j;
+		key = found[j];
+		if (key.mv_size > bufsize)
+			break;
+		memcpy(buf, key.mv_data, key.mv_size);
+		splits[*countp].mv_size = key.mv_size;
+		splits[*countp].mv_data = buf;
+		buf += key.mv_size;
+		bufsize -= key.mv_size;
+		(*countp)++;
+	}
+
+done:
+	for (i = 0; i < nheld; i++)
+		MDB_PAGE_UNREF(txn, held[i]);
+	MDB_CURSOR_UNREF(&mc, 1);
+	free(held);
+	free(found);
+	free(pages < next ? pages : next);
+	return rc;
+}
+
 void mdb_dbi_close(MDB_env *env, MDB_dbi dbi)
 {
 	char *ptr;
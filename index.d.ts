@@ -45,6 +45,14 @@ declare namespace lmdb {
 		 **/
 		getBinaryFast(id: K): Buffer | undefined;
 
+		/**
+		 * Read the value stored by given id/key in binary format into the target, up to the length of the target
+		 * (only decompressing what fits), returning the full length of the value.
+		 * @param id The key for the entry
+		 * @param target The buffer to read the value into
+		 **/
+		getBinaryInto(id: K, target: Uint8Array): number | undefined;
+
 		/**
 		 * For random access structures and "fast" binary data, the underlying data is volatile,
 		 * and not safe to access after the next get. This function allows the data to
@@ -73,6 +81,19 @@ declare namespace lmdb {
 			callback?: (error: any, values: V[]) => any,
 		): Promise<(V | undefined)[]>;
 
+		/**
+		 * Synchronously get the values stored by the given ids and return the
+		 * values in array corresponding to the array of ids. The values are
+		 * retrieved with a single batched native call where possible.
+		 * @param ids The keys for the entries to get
+		 * @param options.sortKeys Look up the keys in sorted order, walking
+		 * forward from the previous key when the next key is close
+		 **/
+		getManySync(
+			ids: K[],
+			options?: GetOptions & { sortKeys?: boolean },
+		): (V | undefined)[];
+
 		/**
 		 * @experimental Asynchronously get a value by id.
 		 * @param ids
@@ -183,6 +204,41 @@ declare namespace lmdb {
 		getRange(
 			options?: RangeOptions,
 		): RangeIterable<{ key: K; value: V; version?: number }>;
+		/**
+		 * Compute aggregates over the entries in the given range natively,
+		 * without returning the entries
+		 * @param options The options for the range, and the type and offset
+		 * of the number in each value to aggregate
+		 **/
+		getAggregate(options?: AggregateOptions): Aggregate<K>;
+		/**
+		 * Get the entries for the given range, reading the parts of the range
+		 * in parallel on the read threads, with all parts on the same snapshot
+		 * @param options The options for the range/iterator
+		 * @param options.parts The number of parts to split the range into
+		 * @param options.ordered Return the entries in key order (true by
+		 * default), or in the order the batches of entries are read
+		 **/
+		getRangeParallel(
+			options?: RangeOptions & { parts?: number; ordered?: boolean },
+		): AsyncIterable<{ key: K; value: V; version?: number }>;
+		/**
+		 * Find keys that split the given range into parts of similar size, by
+		 * sampling the branch pages of the database
+		 * @param options The start and end of the range
+		 * @param parts The number of parts to split the range into
+		 **/
+		getRangeSplits(options: RangeOptions, parts?: number): K[];
+		/**
+		 * Build a compression dictionary from values sampled across the database
+		 * @param options The maximum size of the dictionary, the number of bytes
+		 * to sample, and the codec to build the dictionary for
+		 **/
+		trainDictionary(options?: {
+			size?: number;
+			sampleSize?: number;
+			codec?: 'lz4' | 'lz4hc' | 'zstd';
+		}): Buffer;
 		/**
 		 * Get the count of all the entries for the given range
 		 * existing version
@@ -362,14 +418,21 @@ declare namespace lmdb {
 		sharedStructuresKey?: Key;
 		useVersions?: boolean;
 		keyEncoding?: 'uint32' | 'binary' | 'ordered-binary';
+		keyPrefix?: Key;
 		dupSort?: boolean;
 		strictAsyncOrder?: boolean;
+		/** Set to 'low' to write all the puts and removes of this database through the low priority lane (see PutOptions.priority) */
+		writePriority?: 'normal' | 'low';
 	}
 	interface RootDatabaseOptions extends DatabaseOptions {
 		/** The maximum number of databases to be able to open (there is some extra overhead if this is set very high).*/
 		maxDbs?: number;
 		/** Set a longer delay (in milliseconds) to wait longer before committing writes to increase the number of writes per transaction (higher latency, but more efficient) **/
 		commitDelay?: number;
+		/** Under load (writes arriving while the previous transaction commits), the write thread holds batch transactions open for more writes, for up to this many milliseconds, rather than committing as soon as the queued writes run out. When idle, writes are still committed immediately. **/
+		commitLatencyBudget?: number;
+		/** The maximum number of low priority writes to include in each transaction (defaults to 1000) **/
+		lowPriorityBatchSize?: number;
 		/**
 		 * This can be used to specify the initial amount of how much virtual memory address space (in bytes) to allocate for mapping to the database files.
 		 * Setting a map size will typically disable remapChunks by default unless the size is larger than appropriate for the OS. Different OSes have different allocation limits.
@@ -382,6 +445,9 @@ declare namespace lmdb {
 		pageSize?: number;
 		/** This enables committing transactions where LMDB waits for a transaction to be fully flushed to disk after the transaction has been committed and defaults to being enabled on non-Windows OSes. This option is discussed in more detail below. */
 		overlappingSync?: boolean;
+		groupSync?: boolean | number;
+		/** On Linux, submit all the page writes of a commit (and the sync of the data file, for synchronous commits) through io_uring as one batch. This can be true, or the number of entries in the ring (defaults to 256). Falls back to the normal writes when io_uring is not available. */
+		ioUring?: boolean | number;
 		/** Resolve asynchronous operations when commits are finished and visible and include a separate promise for when a commit is flushed to disk, as a flushed property on the commit promise. Note that you can alternately use the flushed property on the database. */
 		separateFlushed?: boolean;
 		/**
@@ -428,6 +494,12 @@ declare namespace lmdb {
 	interface CompressionOptions {
 		threshold?: number;
 		dictionary?: Buffer;
+		/** The codec used to compress new entries (zstd requires a build with LMDB_ZSTD=true) **/
+		codec?: 'lz4' | 'lz4hc' | 'zstd';
+		/** The compression level for lz4hc and zstd **/
+		level?: number;
+		/** Versioned dictionaries, new entries are compressed with the last one **/
+		dictionaries?: Buffer[];
 	}
 	interface GetOptions {
 		transaction?: Transaction;
@@ -451,9 +523,40 @@ declare namespace lmdb {
 		offset?: number;
 		/** Use a snapshot of the database from when the iterator started **/
 		snapshot?: boolean;
+		/** Read entries from the database in batches (many entries per native call) **/
+		batch?: boolean;
 		/** Use the provided transaction for this range query */
 		transaction?: Transaction;
 	}
+	interface AggregateOptions extends RangeOptions {
+		/** The type of the number to aggregate in each value **/
+		valueType?:
+			| 'int8'
+			| 'uint8'
+			| 'int16'
+			| 'uint16'
+			| 'int32'
+			| 'uint32'
+			| 'float32'
+			| 'float64'
+			| 'int64'
+			| 'uint64';
+		/** The byte offset of the number in each value **/
+		valueOffset?: number;
+		/** The number is big-endian (little-endian by default) **/
+		bigEndian?: boolean;
+	}
+	interface Aggregate<K> {
+		count: number;
+		keyBytes: number;
+		valueBytes: number;
+		minKey?: K;
+		maxKey?: K;
+		valueCount?: number;
+		sum?: number;
+		min?: number;
+		max?: number;
+	}
 	interface PutOptions {
 		/* Append to the database using MDB_APPEND, which can be faster */
 		append?: boolean;
@@ -465,6 +568,8 @@ declare namespace lmdb {
 		noDupData?: boolean;
 		/* The version of the entry to set */
 		version?: number;
+		/* Low priority writes (like bulk imports) are queued separately and written in chunks, behind normal writes */
+		priority?: 'normal' | 'low';
 	}
 	export enum TransactionFlags {
 		/* Indicates that the transaction needs to be abortable */
@@ -501,5 +606,58 @@ declare namespace lmdb {
 	export let v8AccelerationEnabled: boolean;
 	/* Return database augmented with methods to better conform to levelup */
 	export function levelup(database: Database): Database;
+	/* Open a database that is sharded across multiple database environments, each with its own write thread */
+	export function openSharded<V = any, K extends Key = Key>(
+		path: string,
+		options: ShardedDatabaseOptions<K>,
+	): ShardedDatabase<V, K>;
+	export function openSharded<V = any, K extends Key = Key>(
+		options: ShardedDatabaseOptions<K> & { path: string },
+	): ShardedDatabase<V, K>;
+	interface ShardedDatabaseOptions<K extends Key = Key> extends RootDatabaseOptions {
+		/* The number of shards (database environments), defaults to 4 */
+		shards?: number;
+		/* Returns the index of the shard for a key, instead of hashing the key */
+		shardKey?: (key: K) => number;
+		/* Boundary keys for sharding by key ranges, each shard holds the keys from the previous boundary (inclusive) to its boundary (exclusive) */
+		shardRanges?: K[];
+	}
+	class ShardedDatabase<V = any, K extends Key = Key> {
+		/* The database of each shard */
+		shards: Database<V, K>[];
+		getShard(key: K): Database<V, K>;
+		getShardIndex(key: K): number;
+		openDB<OV = V, OK extends Key = K>(
+			name: string,
+			options?: DatabaseOptions,
+		): ShardedDatabase<OV, OK>;
+		openDB<OV = V, OK extends Key = K>(
+			options: DatabaseOptions & { name: string },
+		): ShardedDatabase<OV, OK>;
+		get(id: K, options?: GetOptions): V | undefined;
+		getEntry(id: K, options?: GetOptions): { value: V; version?: number } | undefined;
+		getBinary(id: K, options?: GetOptions): Buffer | undefined;
+		doesExist(key: K, valueOrVersion?: any): boolean;
+		getValues(key: K, options?: RangeOptions): RangeIterable<V>;
+		getMany(ids: K[], callback?: (error: any, values: V[]) => any): Promise<(V | undefined)[]>;
+		getManySync(ids: K[], options?: GetOptions): (V | undefined)[];
+		put(id: K, value: V, version?: number | PutOptions, ifVersion?: number): Promise<boolean>;
+		putSync(id: K, value: V, version?: number | PutOptions, ifVersion?: number): boolean;
+		remove(id: K, valueOrIfVersion?: V | number): Promise<boolean>;
+		removeSync(id: K, valueOrIfVersion?: V | number): boolean;
+		/* Conditional writes in the callback must be for keys in the same shard as this key */
+		ifVersion(id: K, ifVersion: number | null, action: () => any): Promise<boolean>;
+		/* Merge of the ordered ranges of all the shards */
+		getRange(options?: RangeOptions): RangeIterable<{ key: K; value: V; version?: number }>;
+		getKeys(options?: RangeOptions): RangeIterable<K>;
+		getCount(options?: RangeOptions): number;
+		getStats(): { entryCount: number; shards: {}[] };
+		clearAsync(): Promise<void[]>;
+		clearSync(): void;
+		drop(): Promise<void[]>;
+		committed: Promise<boolean[]>;
+		flushed: Promise<boolean[]>;
+		close(): Promise<void[]>;
+	}
 }
 export = lmdb;
@@ -32,8 +32,10 @@ export {
 export { ABORT, IF_EXISTS, asBinary } from './write.js';
 import { ABORT, IF_EXISTS, asBinary } from './write.js';
 export { levelup } from './level.js';
+export { openSharded } from './sharded.js';
 export { SKIP } from '@harperfast/extended-iterable';
 import { levelup } from './level.js';
+import { openSharded } from './sharded.js';
 export { clearKeptObjects, version } from './native.js';
 import { nativeAddon } from './native.js';
 export let { noop } = nativeAddon;
@@ -86,6 +88,7 @@ export default {
 	IF_EXISTS,
 	asBinary,
 	levelup,
+	openSharded,
 	TransactionFlags,
 	version,
 };
@@ -58,8 +58,69 @@ export function applyKeyHandling(store) {
 		store.writeKey = orderedBinary.writeKey;
 		store.readKey = orderedBinary.readKey;
 	}
+	if (store.keyPrefix !== undefined) applyKeyPrefix(store);
+}
+// A key prefix that is shared by all the keys of a database is stored once (as an option), rather than in every key,
+// so more keys fit in each page. The prefix is replaced by a single 1 byte when keys are written, and restored when
+// they are read. The prefix itself is saved in the database under KEY_PREFIX_KEY (stored as the single byte 0), so
+// that opening the database with a different prefix can be rejected, and every key and range bound sorts after it.
+export const KEY_PREFIX_KEY = Symbol.for('keyPrefix');
+function applyKeyPrefix(store) {
+	let writeKey = store.writeKey;
+	let readKey = store.readKey;
+	let prefix = store.keyPrefix;
+	if (!(prefix instanceof Uint8Array)) {
+		let target = new Uint8Array(store.maxKeySize || 1978);
+		prefix = target.slice(0, writeKey(prefix, target, 0));
+	}
+	store.keyPrefixBytes = prefix;
+	let prefixLength = prefix.length;
+	store.writeKey = (key, target, start) => {
+		if (key === KEY_PREFIX_KEY) {
+			target[start] = 0;
+			return start + 1;
+		}
+		if (key === store.defaultBeginningKey) {
+			// between the stored prefix and the keys
+			target[start] = 0;
+			target[start + 1] = 0xff;
+			return start + 2;
+		}
+		let end = writeKey(key, target, start);
+		for (let i = 0; i < prefixLength; i++) {
+			if (target[start + i] !== prefix[i]) {
+				target.fill(0, start, end);
+				throw new Error('Key does not start with the keyPrefix of this database');
+			}
+		}
+		target.copyWithin(start + 1, start + prefixLength, end);
+		target[start] = 1;
+		let newEnd = end - prefixLength + 1;
+		// keys are expected to be followed by zeros
+		if (newEnd < end) target.fill(0, newEnd, end);
+		return newEnd;
+	};
+	// the standard key readers copy the key out of the source, so the full key can be assembled in a reused buffer
+	let reuseBuffer = readKey === orderedBinary.readKey || readKey === readBufferKey || readKey === readUint32Key;
+	let fullKey;
+	store.readKey = (source, start, end) => {
+		if (source[start] === 0) return KEY_PREFIX_KEY;
+		start++;
+		let size = prefixLength + end - start;
+		let full = fullKey;
+		if (!reuseBuffer) {
+			full = typeof Buffer != 'undefined' ? Buffer.allocUnsafe(size) : new Uint8Array(size);
+			full.set(prefix);
+		} else if (!full || full.length < size) {
+			// with its own ArrayBuffer, since readUint32Key reads from the start of the buffer
+			fullKey = full = typeof Buffer != 'undefined' ? Buffer.allocUnsafeSlow(Math.max(size, 256)) :
+				new Uint8Array(Math.max(size, 256));
+			full.set(prefix);
+		}
+		full.set(source.subarray(start, end), prefixLength);
+		return readKey(full, 0, size);
+	};
 }
-
 let saveBuffer, uint32, saveDataView = { setFloat64() {}, setUint32() {} }, saveDataAddress;
 let savePosition = 8000;
 let DYNAMIC_KEY_BUFFER_SIZE = 8192;
@@ -27,12 +27,19 @@ export let Env,
 	setEnvMap,
 	getEnvMap,
 	getByBinary,
+	getManyByBinary,
+	getRangeSplits,
+	trainDictionary,
+	getInto,
 	detachBuffer,
 	startRead,
+	startIterateBatch,
 	setReadCallback,
 	write,
 	position,
 	iterate,
+	iterateBatch,
+	aggregate,
 	prefetch,
 	resetTxn,
 	getCurrentValue,
@@ -96,14 +103,21 @@ export function setNativeFunctions(externals) {
 	createBufferForAddress = externals.createBufferForAddress;
 	clearKeptObjects = externals.clearKeptObjects || function () {};
 	getByBinary = externals.getByBinary;
+	getManyByBinary = externals.getManyByBinary;
+	getRangeSplits = externals.getRangeSplits;
+	trainDictionary = externals.trainDictionary;
+	getInto = externals.getInto;
 	detachBuffer = externals.detachBuffer;
 	startRead = externals.startRead;
+	startIterateBatch = externals.startIterateBatch;
 	setReadCallback = externals.setReadCallback;
 	setGlobalBuffer = externals.setGlobalBuffer;
 	globalBuffer = externals.globalBuffer;
 	getSharedBuffer = externals.getSharedBuffer;
 	prefetch = externals.prefetch;
 	iterate = externals.iterate;
+	iterateBatch = externals.iterateBatch;
+	aggregate = externals.aggregate;
 	position = externals.position;
 	resetTxn = externals.resetTxn;
 	directWrite = externals.directWrite;
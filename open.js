@@ -17,8 +17,8 @@ import {
 } from './native.js';
 import { CachingStore, setGetLastVersion } from './caching.js';
 import { addReadMethods, makeReusableBuffer } from './read.js';
-import { addWriteMethods } from './write.js';
-import { applyKeyHandling } from './keys.js';
+import { addWriteMethods, asBinary } from './write.js';
+import { applyKeyHandling, KEY_PREFIX_KEY } from './keys.js';
 let moduleRequire = typeof require == 'function' && require;
 export function setRequire(require) {
 	moduleRequire = require;
@@ -203,6 +203,7 @@ export function open(path, options) {
 		options.pageSize ? MAX_KEY_SIZE : DEFAULT_MAX_KEY_SIZE,
 	);
 	flags = getEnvFlags(env.address); // re-retrieve them, they are not necessarily the same if we are connecting to an existing env
+	env.remapChunks = Boolean(flags & 0x4000000); // read txns can't be shared across threads with remapped chunks
 	if (flags & 0x1000) {
 		if (userOptions.noSync) {
 			env.close();
@@ -400,6 +401,18 @@ export function open(path, options) {
 			}
 			this.maxKeySize = maxKeySize;
 			applyKeyHandling(this);
+			if (this.keyPrefix !== undefined) {
+				// verify that the database was created with the same key prefix, saving the prefix in a new database
+				let prefix = this.keyPrefixBytes;
+				let stored = this.getBinary(KEY_PREFIX_KEY);
+				if (stored) {
+					if (Buffer.compare(stored, prefix) !== 0)
+						throw new Error(
+							'The keyPrefix does not match the keyPrefix this database was created with',
+						);
+				} else if (!options.readOnly)
+					this.putSync(KEY_PREFIX_KEY, asBinary(prefix));
+			}
 			allDbs.set(dbName ? name + '-' + dbName : name, this);
 		}
 		openDB(dbName, dbOptions) {
@@ -6,9 +6,15 @@ import {
 	orderedBinary,
 	lmdbError,
 	getByBinary,
+	getManyByBinary,
+	getRangeSplits,
+	trainDictionary,
+	getInto,
 	setGlobalBuffer,
 	prefetch,
 	iterate,
+	iterateBatch,
+	aggregate,
 	position as doPosition,
 	resetTxn,
 	getCurrentValue,
@@ -17,6 +23,7 @@ import {
 	globalBuffer,
 	getSharedBuffer,
 	startRead,
+	startIterateBatch,
 	setReadCallback,
 	directWrite,
 	getUserSharedBuffer,
@@ -121,6 +128,14 @@ export function addReadMethods(
 			let bytes = compression ? compression.getValueBytes : getValueBytes;
 			if (rc > bytes.maxLength) {
 				// this means the target buffer wasn't big enough, so the get failed to copy all the data from the database, need to either grow or use special buffer
+				if (compression && asSafeBuffer && rc > NEW_BUFFER_THRESHOLD) {
+					// decompress directly into a dedicated buffer of the right size
+					bytes = Buffer.allocUnsafeSlow(rc);
+					let size = this.getBinaryInto(id, bytes, options);
+					if (size === undefined) return; // removed since the size was read
+					this.lastSize = size;
+					return size < bytes.length ? bytes.subarray(0, size) : bytes;
+				}
 				return this._returnLargeBuffer(() =>
 					getByBinary(
 						this.dbAddress,
@@ -150,24 +165,29 @@ export function addReadMethods(
 				this.writeKey,
 				maxKeySize,
 				(rc, bufferId, offset, size) => {
-					if (rc && rc !== 1) callback(lmdbError(rc));
 					outstandingReads--;
+					if (rc && rc !== 1) {
+						// not found (or failed) reads have no result buffer
+						txn.done();
+						return callback(rc == -30798 ? undefined : lmdbError(rc));
+					}
 					let buffer = mmaps[bufferId];
 					if (!buffer) {
 						buffer = mmaps[bufferId] = getSharedBuffer(bufferId, env.address);
 					}
 					//console.log({bufferId, offset, size})
 					if (buffer.isSharedMap) {
-						// using LMDB shared memory
-						// TODO: We may want explicit support for clearing aborting the transaction on the next event turn,
-						// but for now we are relying on the GC to cleanup transaction for larger blocks of memory
-						let bytes = new Uint8Array(buffer, offset, size);
-						bytes.txn = txn;
-						callback(bytes, 0, size);
+						// using LMDB shared memory, directly from the memory map, the read txn is held open
+						// (pinning the snapshot) until the callback has used the data
+						try {
+							callback(buffer, offset, size, true);
+						} finally {
+							txn.done(); // decrement and possibly abort
+						}
 					} else {
-						// using copied memory
+						// using copied memory, which will be reused once this callback returns
 						txn.done(); // decrement and possibly abort
-						callback(buffer, offset, size);
+						callback(buffer, offset, size, true);
 					}
 				},
 			);
@@ -178,9 +198,15 @@ export function addReadMethods(
 			}
 		},
 		getAsync(id, options, callback) {
-			let promise;
-			if (!callback) promise = new Promise((resolve) => (callback = resolve));
-			this.getBFAsync(id, options, (buffer, offset, size) => {
+			let promise, reject;
+			if (!callback)
+				promise = new Promise((resolve, rejectPromise) => {
+					callback = resolve;
+					reject = rejectPromise;
+				});
+			this.getBFAsync(id, options, (buffer, offset, size, isTransient) => {
+				if (!buffer) return callback(); // not found
+				if (buffer instanceof Error) return reject ? reject(buffer) : callback(buffer);
 				if (this.useVersions) {
 					// TODO: And get the version
 					offset += 8;
@@ -190,9 +216,15 @@ export function addReadMethods(
 				let value;
 				if (this.decoder) {
 					// the decoder potentially uses the data from the buffer in the future and needs a stable buffer
-					value = bytes && this.decoder.decode(bytes);
+					value =
+						bytes &&
+						this.decoder.decode(
+							isTransient && !this.decoderCopies
+								? Uint8ArraySlice.call(bytes)
+								: bytes,
+						);
 				} else if (this.encoding == 'binary') {
-					value = bytes;
+					value = isTransient ? Uint8ArraySlice.call(bytes) : bytes;
 				} else {
 					value = Buffer.prototype.utf8Slice.call(bytes, 0, size);
 					if (this.encoding == 'json' && value) value = JSON.parse(value);
@@ -319,6 +351,27 @@ export function addReadMethods(
 				asSafeBuffer = false;
 			}
 		},
+		getBinaryInto(id, target, options) {
+			// reads (decompressing if needed) the value into the target, up to the length of the target, returning the
+			// full size of the value, so just the start of a large value can be read, without the rest being decompressed
+			let txn =
+				env.writeTxn ||
+				(options && options.transaction) ||
+				(readTxnRenewed ? readTxn : renewReadTxn(this));
+			let rc = getInto(
+				this.dbAddress,
+				this.writeKey(id, keyBytes, 0),
+				txn.address || 0,
+				getAddress(target.buffer) + target.byteOffset,
+				target.length,
+			);
+			if (rc < 0) {
+				if (rc == -30798) return; // MDB_NOTFOUND
+				if (rc == -30000) return keyBytesView.getUint32(0, isLittleEndian);
+				lmdbError(rc);
+			}
+			return rc;
+		},
 		getSharedBinary(id, options) {
 			let fastBuffer = this.getBinaryFast(id, options);
 			if (fastBuffer) {
@@ -506,6 +559,11 @@ export function addReadMethods(
 			options.onlyCount = true;
 			return this.getRange(options).iterate();
 		},
+		getAggregate(options) {
+			if (!options) options = {};
+			options.onlyAggregate = true;
+			return this.getRange(options).iterate();
+		},
 		getKeysCount(options) {
 			if (!options) options = {};
 			options.onlyCount = true;
@@ -544,6 +602,12 @@ export function addReadMethods(
 				let count = 0;
 				let cursor, cursorRenewId, cursorAddress;
 				let txn;
+				// entries are read in batches (after the first one), and then read from the batch buffer
+				let batch,
+					batchPosition = 0,
+					batchRemaining = 0;
+				let useBatches = options.batch !== false;
+				let batchHeaderSize = includeValues && this.useVersions ? 16 : 8;
 				let flags =
 					(includeValues ? 0x100 : 0) |
 					(reverse ? 0x400 : 0) |
@@ -605,6 +669,11 @@ export function addReadMethods(
 					}
 				}
 				resetCursor();
+				if (options.onlyAggregate) {
+					let aggregate = position(options.offset);
+					finishCursor();
+					return aggregate;
+				}
 				if (options.onlyCount) {
 					flags |= 0x1000;
 					let count = position(options.offset);
@@ -686,6 +755,29 @@ export function addReadMethods(
 							iterable,
 							maxKeySize,
 						);
+					if (options.onlyAggregate) {
+						let valueType = 0;
+						if (options.valueType) {
+							valueType = AGGREGATE_VALUE_TYPES[options.valueType];
+							if (!valueType)
+								throw new Error('Invalid value type ' + options.valueType);
+							if (options.bigEndian) valueType |= AGGREGATE_BIG_ENDIAN;
+						}
+						if (!getManyBytes) allocateGetManyBuffer(GET_MANY_BUFFER_SIZE);
+						let rc = aggregate(
+							cursorAddress,
+							flags | 0x100, // include values, so each entry of a dupsort db is aggregated
+							offset || 0,
+							keySize,
+							endAddress,
+							getManyBytes.address,
+							getManyBytes.length,
+							options.valueOffset || 0,
+							valueType,
+						);
+						if (rc < 0) lmdbError(rc);
+						return readAggregate(store, reverse, valueType);
+					}
 					return doPosition(
 						cursorAddress,
 						flags,
@@ -725,7 +817,11 @@ export function addReadMethods(
 				return {
 					next() {
 						let keySize, lastSize;
-						if (cursorRenewId && (cursorRenewId != renewId || txn.isDone)) {
+						if (
+							cursorRenewId &&
+							batchRemaining === 0 &&
+							(cursorRenewId != renewId || txn.isDone)
+						) {
 							if (flags & 0x10000) flags = flags & ~0x10000; // turn off exclusive start when repositioning
 							resetCursor();
 							keySize = position(0);
@@ -733,10 +829,44 @@ export function addReadMethods(
 						if (!cursor) {
 							return ITERATOR_DONE;
 						}
-						if (count === 0) {
-							// && includeValues) // on first entry, get current value if we need to
-							keySize = position(options.offset);
-						} else keySize = iterate(cursorAddress);
+						let batchEntry = -1; // position of the current entry in the batch
+						if (batchRemaining === 0) {
+							if (count === 0) {
+								// && includeValues) // on first entry, get current value if we need to
+								keySize = position(options.offset);
+							} else if (useBatches) {
+								if (!batch) batch = allocateBatchBuffer(BATCH_BUFFER_SIZE);
+								else if (
+									batch.length < MAX_BATCH_BUFFER_SIZE &&
+									batchPosition > batch.length >> 1
+								)
+									batch = allocateBatchBuffer(batch.length << 1); // the last batch was mostly full
+								keySize = iterateBatch(
+									cursorAddress,
+									batch.address,
+									batch.length,
+									limit === undefined ? 0xffffffff : Math.max(limit - count, 1),
+								);
+								if (keySize > 0) {
+									batchRemaining = keySize;
+									batchPosition = 0;
+								}
+							} else keySize = iterate(cursorAddress);
+						}
+						let batchValueSize;
+						if (batchRemaining > 0) {
+							batchRemaining--;
+							batchEntry = batchPosition;
+							keySize = batch.dataView.getUint32(batchEntry, isLittleEndian);
+							batchValueSize = batch.dataView.getUint32(
+								batchEntry + 4,
+								isLittleEndian,
+							);
+							let keyStart = batchEntry + batchHeaderSize;
+							batchPosition = keyStart + ((keySize + 8) & ~7);
+							if (batchValueSize !== BATCH_VALUE_NOT_INCLUDED)
+								batchPosition = (batchPosition + batchValueSize + 7) & ~7;
+						}
 						if (keySize <= 0 || count++ >= limit) {
 							if (keySize < -30700 && keySize !== -30798) lmdbError(keySize);
 							finishCursor();
@@ -747,29 +877,53 @@ export function addReadMethods(
 								if (keySize > 0x1000000) lmdbError(keySize - 0x100000000);
 								throw new Error('Invalid key size ' + keySize.toString(16));
 							}
-							currentKey = store.readKey(keyBytes, 32, keySize + 32);
+							if (batchEntry >= 0) {
+								let keyStart = batchEntry + batchHeaderSize;
+								currentKey = store.readKey(batch, keyStart, keyStart + keySize);
+							} else currentKey = store.readKey(keyBytes, 32, keySize + 32);
+						}
+						if (batchEntry >= 0 && includeVersions && store.useVersions) {
+							// make the version available to getLastVersion()
+							keyBytes.set(batch.subarray(batchEntry + 8, batchEntry + 16), 16);
 						}
 						if (includeValues) {
 							let value;
-							lastSize = keyBytesView.getUint32(0, isLittleEndian);
-							let bufferId = keyBytesView.getUint32(4, isLittleEndian);
 							let bytes;
-							if (bufferId) {
-								bytes = getMMapBuffer(bufferId, lastSize);
-								if (store.encoding === 'binary') bytes = Buffer.from(bytes);
+							if (
+								batchEntry >= 0 &&
+								batchValueSize !== BATCH_VALUE_NOT_INCLUDED
+							) {
+								// the value is in the batch buffer, which is reused for the next batch
+								lastSize = batchValueSize;
+								let valueStart =
+									batchEntry + batchHeaderSize + ((keySize + 8) & ~7);
+								bytes = batch.subarray(valueStart, valueStart + lastSize);
+								bytes.isGlobal = true;
 							} else {
-								bytes = compression ? compression.getValueBytes : getValueBytes;
-								store.lastSize = lastSize;
-								if (lastSize > bytes.maxLength) {
-									asSafeBuffer = store.encoding === 'binary';
-									try {
-										bytes = store._returnLargeBuffer(() =>
-											getCurrentValue(cursorAddress),
-										);
-									} finally {
-										asSafeBuffer = false;
-									}
-								} else bytes.length = lastSize;
+								if (batchEntry >= 0) {
+									// too large for the batch, the cursor was left on this entry to get it directly
+									let rc = getCurrentValue(cursorAddress);
+									if (rc < 0) lmdbError(rc);
+								}
+								lastSize = keyBytesView.getUint32(0, isLittleEndian);
+								let bufferId = keyBytesView.getUint32(4, isLittleEndian);
+								if (bufferId) {
+									bytes = getMMapBuffer(bufferId, lastSize);
+									if (store.encoding === 'binary') bytes = Buffer.from(bytes);
+								} else {
+									bytes = compression ? compression.getValueBytes : getValueBytes;
+									store.lastSize = lastSize;
+									if (lastSize > bytes.maxLength) {
+										asSafeBuffer = store.encoding === 'binary';
+										try {
+											bytes = store._returnLargeBuffer(() =>
+												getCurrentValue(cursorAddress),
+											);
+										} finally {
+											asSafeBuffer = false;
+										}
+									} else bytes.length = lastSize;
+								}
 							}
 							if (store.decoder) {
 								value = store.decoder.decode(
@@ -841,22 +995,350 @@ export function addReadMethods(
 		getMany(keys, callback) {
 			// this is an asynchronous get for multiple keys. It actually works by prefetching asynchronously,
 			// allowing a separate thread/task to absorb the potentially largest cost: hard page faults (and disk I/O).
-			// And then we just do standard sync gets (to deserialized data) to fulfil the callback/promise
+			// And then we just do a batched sync get (to deserialized data) to fulfil the callback/promise
 			// once the prefetch occurs
 			let promise = callback
 				? undefined
 				: new Promise(
-						(resolve) => (callback = (error, results) => resolve(results)),
+						(resolve, reject) =>
+							(callback = (error, results) =>
+								error ? reject(error) : resolve(results)),
 					);
 			this.prefetch(keys, () => {
-				let results = new Array(keys.length);
-				for (let i = 0, l = keys.length; i < l; i++) {
-					results[i] = get.call(this, keys[i]);
+				let results;
+				try {
+					results = this.getManySync(keys);
+				} catch (error) {
+					return callback(error);
 				}
 				callback(null, results);
 			});
 			return promise;
 		},
+		getManySync(keys, options) {
+			// retrieves all the values with (usually) a single native call, that copies all the values into one
+			// buffer, and then we decode each of them from there
+			let txn =
+				env.writeTxn ||
+				(options && options.transaction) ||
+				(readTxnRenewed ? readTxn : renewReadTxn(this));
+			let mode = options && options.sortKeys ? GET_MANY_SORTED : 0;
+			if (!getManyBytes) allocateGetManyBuffer(GET_MANY_BUFFER_SIZE);
+			let results = new Array(keys.length);
+			let pending; // indices of the keys that still need to be retrieved, after the first call
+			let callKeys = keys;
+			while (callKeys.length > 0) {
+				let buffers = []; // keep the key buffers referenced until the native call is done
+				let keysAddress = saveKeys(
+					callKeys,
+					this.writeKey,
+					maxKeySize,
+					buffers,
+				);
+				let count = getManyByBinary(
+					this.dbAddress,
+					keysAddress,
+					getManyBytes.address,
+					getManyBytes.length,
+					txn.address || 0,
+					mode,
+				);
+				if (count < 0) lmdbError(count);
+				// if they weren't all resolved, track which ones were (they may not be in order if sorted)
+				let resolved =
+					count < callKeys.length && new Uint8Array(callKeys.length);
+				let position = 0;
+				for (let j = 0; j < count; j++) {
+					let size = getManyView.getUint32(position, isLittleEndian);
+					let status = getManyView.getUint32(position + 4, isLittleEndian);
+					let header = position;
+					let start = position + GET_MANY_HEADER_SIZE;
+					if (size) position = (start + size + 7) & ~7;
+					else position = start;
+					let index = status >>> 2;
+					if (resolved) resolved[index] = 1;
+					if (pending) index = pending[index];
+					status &= 3;
+					if (status === GET_MANY_NOT_FOUND) continue; // undefined
+					if (status === GET_MANY_INDIVIDUALLY) {
+						results[index] = get.call(this, keys[index], options);
+						continue;
+					}
+					let bytes = getManyBytes.subarray(start, start + size);
+					let value;
+					if (this.decoder) {
+						value = this.decoder.decode(
+							this.decoderCopies ? bytes : Uint8ArraySlice.call(bytes),
+						);
+					} else if (this.encoding == 'binary')
+						value = Uint8ArraySlice.call(bytes);
+					else {
+						value = bytes.utf8Slice
+							? bytes.utf8Slice(0, size)
+							: new TextDecoder().decode(bytes);
+						if (this.encoding == 'json' && value) value = JSON.parse(value);
+					}
+					results[index] = value;
+					this.lastSize = size;
+					if (this.useVersions) {
+						// make the version available to getLastVersion()
+						keyBytes.set(getManyBytes.subarray(header + 8, header + 16), 16);
+					}
+				}
+				if (!resolved) break;
+				if (count === 0) {
+					// couldn't make any progress with a batch (like an invalid key), get the next one individually
+					let index = pending ? pending[0] : 0;
+					results[index] = get.call(this, keys[index], options);
+					resolved[0] = 1;
+				} else if (getManyBytes.length < MAX_GET_MANY_BUFFER_SIZE)
+					allocateGetManyBuffer(getManyBytes.length << 1);
+				let nextPending = [];
+				for (let j = 0, l = callKeys.length; j < l; j++) {
+					if (!resolved[j]) nextPending.push(pending ? pending[j] : j);
+				}
+				pending = nextPending;
+				callKeys = pending.map((index) => keys[index]);
+			}
+			return results;
+		},
+		getRangeSplits(options, parts) {
+			// finds keys that split the range into (up to) the given number of parts of similar size, by sampling the
+			// branch pages of the database (without reading the entries)
+			if (!options) options = {};
+			let txn =
+				env.writeTxn ||
+				options.transaction ||
+				(readTxnRenewed ? readTxn : renewReadTxn(this));
+			let startHolder = {};
+			let startAddress = saveKey(
+				options.start,
+				this.writeKey,
+				startHolder,
+				maxKeySize,
+			);
+			let endHolder = {}; // keep the key buffers referenced until the native call is done
+			let endAddress = saveKey(
+				options.end,
+				this.writeKey,
+				endHolder,
+				maxKeySize,
+			);
+			if (!getManyBytes) allocateGetManyBuffer(GET_MANY_BUFFER_SIZE);
+			let count = getRangeSplits(
+				this.dbAddress,
+				txn.address || 0,
+				parts || DEFAULT_PARALLEL_PARTS,
+				startAddress,
+				endAddress,
+				getManyBytes.address,
+				getManyBytes.length,
+			);
+			if (count < 0) lmdbError(count);
+			let splits = [];
+			let position = 0;
+			for (let i = 0; i < count; i++) {
+				let size = getManyView.getUint32(position, isLittleEndian);
+				splits.push(
+					this.readKey(getManyBytes, position + 4, position + 4 + size),
+				);
+				position = (position + size + 7) & ~3;
+			}
+			return splits;
+		},
+		trainDictionary(options) {
+			// builds a compression dictionary from values sampled evenly across the database, which can be added to
+			// the compression's versioned dictionaries
+			if (!options) options = {};
+			let size = options.size || DEFAULT_DICTIONARY_SIZE;
+			let txn =
+				env.writeTxn ||
+				options.transaction ||
+				(readTxnRenewed ? readTxn : renewReadTxn(this));
+			let compression = this.compression;
+			// make sure there is a decompression target, so compressed values can be sampled
+			if (
+				compression &&
+				!(compression.getValueBytes?.maxLength >= 0x10000)
+			)
+				this._allocateGetBuffer(0x8000);
+			let codec = options.codec || compression?.codec || 'lz4';
+			let dictionary = Buffer.allocUnsafeSlow(size);
+			let written = trainDictionary(
+				this.dbAddress,
+				txn.address || 0,
+				getAddress(dictionary.buffer) + dictionary.byteOffset,
+				size,
+				options.sampleSize || size * 16,
+				COMPRESSION_CODECS[codec] || 0,
+			);
+			if (written < 0) lmdbError(written);
+			return dictionary.subarray(0, written);
+		},
+		async *getRangeParallel(options) {
+			// scans a range with a cursor for each part of the range, with the batches of entries for the parts read
+			// by the read threads in parallel. The cursors all share one read txn, so they are on the same snapshot.
+			if (!options) options = {};
+			if (options.reverse || options.valuesForKey || options.offset)
+				throw new Error(
+					'Parallel range scans do not support reverse, valuesForKey or offset',
+				);
+			if (env.writeTxn || env.remapChunks) {
+				// a write txn can't be used by other threads, and a read txn can't be shared across threads with
+				// remapped chunks, so just iterate the range in order
+				yield* this.getRange(options);
+				return;
+			}
+			let includeValues = options.values !== false;
+			let includeVersions = options.versions;
+			let headerSize = includeValues && this.useVersions ? 16 : 8;
+			let limit = options.limit;
+			let count = 0;
+			let txn =
+				options.transaction || (readTxnRenewed ? readTxn : renewReadTxn(this));
+			txn.use();
+			let scans = [];
+			let store = this;
+			function readNext(scan) {
+				scan.promise = new Promise((resolve) => {
+					startIterateBatch(
+						scan.cursor.address,
+						scan.batch.address,
+						scan.batch.length,
+						0xffffffff,
+						addReadCallback(() => resolve(scan)),
+					);
+				});
+			}
+			function readEntries(scan) {
+				// decode the batch (so the buffer can be refilled while the entries are consumed)
+				let view = scan.batch.dataView;
+				let entryCount = view.getInt32(0, isLittleEndian);
+				if (entryCount < 0) lmdbError(entryCount);
+				let entries = [];
+				let position = 8;
+				for (let i = 0; i < entryCount; i++) {
+					let keySize = view.getUint32(position, isLittleEndian);
+					let valueSize = view.getUint32(position + 4, isLittleEndian);
+					let keyStart = position + headerSize;
+					let key = store.readKey(scan.batch, keyStart, keyStart + keySize);
+					position = keyStart + ((keySize + 8) & ~7);
+					if (!includeValues) {
+						entries.push(key);
+						continue;
+					}
+					let value;
+					if (valueSize === BATCH_VALUE_NOT_INCLUDED) {
+						// too large for the batch or compressed, get it directly
+						value = get.call(store, key, { transaction: txn });
+					} else {
+						let bytes = scan.batch.subarray(position, position + valueSize);
+						position = (position + valueSize + 7) & ~7;
+						if (store.decoder) {
+							value = store.decoder.decode(
+								store.decoderCopies ? bytes : Uint8ArraySlice.call(bytes),
+							);
+						} else if (store.encoding == 'binary')
+							value = Uint8ArraySlice.call(bytes);
+						else {
+							value = bytes.utf8Slice
+								? bytes.utf8Slice(0, valueSize)
+								: new TextDecoder().decode(bytes);
+							if (store.encoding == 'json' && value) value = JSON.parse(value);
+						}
+					}
+					entries.push(
+						includeVersions
+							? {
+									key,
+									value,
+									version:
+										headerSize > 8
+											? view.getFloat64(keyStart - 8, isLittleEndian)
+											: undefined,
+								}
+							: { key, value },
+					);
+				}
+				if (entryCount > 0) readNext(scan);
+				else scan.promise = null;
+				return entries;
+			}
+			try {
+				let start =
+					'start' in options ? options.start : this.defaultBeginningKey;
+				let boundaries = [
+					start,
+					...this.getRangeSplits(
+						{ start, end: options.end, transaction: txn },
+						options.parts,
+					),
+					options.end,
+				];
+				for (let i = 0; i < boundaries.length - 1; i++) {
+					let last = i === boundaries.length - 2;
+					let flags =
+						(includeValues ? 0x100 : 0) |
+						(last && options.inclusiveEnd ? 0x8000 : 0) |
+						(i === 0 && options.exclusiveStart ? 0x10000 : 0) |
+						0x20000; // leave the first entry for the first batch
+					let scan = {
+						cursor: new Cursor(this.db, txn.address),
+						batch: allocateBatchBuffer(PARALLEL_BATCH_BUFFER_SIZE),
+						endHolder: {}, // the end key must stay referenced while the cursor is used
+						promise: null,
+					};
+					scans.push(scan);
+					let keySize =
+						boundaries[i] === undefined
+							? 0
+							: this.writeKey(boundaries[i], keyBytes, 0);
+					let endAddress = saveKey(
+						boundaries[i + 1],
+						this.writeKey,
+						scan.endHolder,
+						maxKeySize,
+					);
+					let rc = doPosition(
+						scan.cursor.address,
+						flags,
+						0,
+						keySize,
+						endAddress,
+					);
+					if (rc < 0) lmdbError(rc);
+					if (rc > 0) readNext(scan);
+				}
+				if (options.ordered === false) {
+					// yield the batches in the order that they are read
+					let active;
+					while ((active = scans.filter((scan) => scan.promise)).length > 0) {
+						let scan = await Promise.race(active.map((scan) => scan.promise));
+						for (let entry of readEntries(scan)) {
+							if (limit !== undefined && count++ >= limit) return;
+							yield entry;
+						}
+					}
+				} else {
+					for (let scan of scans) {
+						while (scan.promise) {
+							await scan.promise;
+							for (let entry of readEntries(scan)) {
+								if (limit !== undefined && count++ >= limit) return;
+								yield entry;
+							}
+						}
+					}
+				}
+			} finally {
+				// the cursors can't be closed while the read threads are using them
+				for (let scan of scans) {
+					if (scan.promise) await scan.promise;
+					scan.cursor.close();
+				}
+				txn.done();
+			}
+		},
 		getSharedBufferForGet(id, options) {
 			let txn =
 				env.writeTxn ||
@@ -907,35 +1389,13 @@ export function addReadMethods(
 				} else return Promise.resolve();
 			}
 			let buffers = [];
-			let startPosition;
-			let bufferHolder = {};
-			let lastBuffer;
-			for (let key of keys) {
-				let position;
-				if (key && key.key !== undefined && key.value !== undefined) {
-					position = saveKey(
-						key.value,
-						this.writeKey,
-						bufferHolder,
-						maxKeySize,
-						0x80000000,
-					);
-					saveReferenceToBuffer();
-					saveKey(key.key, this.writeKey, bufferHolder, maxKeySize);
-				} else {
-					position = saveKey(key, this.writeKey, bufferHolder, maxKeySize);
-				}
-				if (!startPosition) startPosition = position;
-				saveReferenceToBuffer();
-			}
-			function saveReferenceToBuffer() {
-				if (bufferHolder.saveBuffer != lastBuffer) {
-					buffers.push(bufferHolder.saveBuffer);
-					lastBuffer = bufferHolder.saveBuffer;
-				}
-			}
-			saveKey(undefined, this.writeKey, bufferHolder, maxKeySize);
-			saveReferenceToBuffer();
+			let startPosition = saveKeys(
+				keys,
+				this.writeKey,
+				maxKeySize,
+				buffers,
+				true,
+			);
 			outstandingReads++;
 			prefetch(this.dbAddress, startPosition, (error) => {
 				outstandingReads--;
@@ -1087,6 +1547,131 @@ export function addReadMethods(
 		}
 	}
 }
+// saves a sequence of keys in the layout that the native prefetch and get-many functions read, returning the address
+// of the first key, and recording the buffers that hold the keys
+function saveKeys(keys, writeKey, maxKeySize, buffers, withValues) {
+	let startPosition;
+	let bufferHolder = {};
+	let lastBuffer;
+	for (let key of keys) {
+		let position;
+		if (withValues && key && key.key !== undefined && key.value !== undefined) {
+			position = saveKey(
+				key.value,
+				writeKey,
+				bufferHolder,
+				maxKeySize,
+				0x80000000,
+			);
+			saveReferenceToBuffer();
+			saveKey(key.key, writeKey, bufferHolder, maxKeySize);
+		} else {
+			position = saveKey(key, writeKey, bufferHolder, maxKeySize);
+		}
+		if (!startPosition) startPosition = position;
+		saveReferenceToBuffer();
+	}
+	function saveReferenceToBuffer() {
+		if (bufferHolder.saveBuffer != lastBuffer) {
+			buffers.push(bufferHolder.saveBuffer);
+			lastBuffer = bufferHolder.saveBuffer;
+		}
+	}
+	let position = saveKey(undefined, writeKey, bufferHolder, maxKeySize);
+	if (!startPosition) startPosition = position;
+	saveReferenceToBuffer();
+	return startPosition;
+}
+const BATCH_BUFFER_SIZE = 0x2000;
+const MAX_BATCH_BUFFER_SIZE = 0x20000;
+const BATCH_VALUE_NOT_INCLUDED = 0xffffffff;
+const PARALLEL_BATCH_BUFFER_SIZE = 0x10000;
+const DEFAULT_PARALLEL_PARTS = 4;
+const DEFAULT_DICTIONARY_SIZE = 0x8000;
+const COMPRESSION_CODECS = { lz4: 0, lz4hc: 1, zstd: 2 };
+function allocateBatchBuffer(size) {
+	let batch =
+		typeof Buffer != 'undefined'
+			? Buffer.allocUnsafeSlow(size)
+			: new Uint8Array(size);
+	batch.address = getAddress(batch.buffer);
+	// this is also used by the uint32 key reader
+	batch.dataView = new DataView(batch.buffer, 0, size);
+	return batch;
+}
+const AGGREGATE_VALUE_TYPES = {
+	int8: 1,
+	uint8: 2,
+	int16: 3,
+	uint16: 4,
+	int32: 5,
+	uint32: 6,
+	float32: 7,
+	float64: 8,
+	int64: 9,
+	uint64: 10,
+};
+const AGGREGATE_BIG_ENDIAN = 0x100;
+const AGGREGATE_HEADER_SIZE = 56;
+// reads the results of a native aggregate from the get-many buffer
+function readAggregate(store, reverse, valueType) {
+	let result = {
+		count: getManyView.getFloat64(0, isLittleEndian),
+		keyBytes: getManyView.getFloat64(8, isLittleEndian),
+		valueBytes: getManyView.getFloat64(16, isLittleEndian),
+	};
+	let firstKeySize = getManyView.getUint32(
+		AGGREGATE_HEADER_SIZE,
+		isLittleEndian,
+	);
+	if (result.count > 0 && firstKeySize > 0) {
+		let position = AGGREGATE_HEADER_SIZE + 4;
+		let firstKey = store.readKey(
+			getManyBytes,
+			position,
+			position + firstKeySize,
+		);
+		position += (firstKeySize + 3) & ~3;
+		let lastKeySize = getManyView.getUint32(position, isLittleEndian);
+		// a size of zero means the last key didn't fit in the buffer
+		let lastKey =
+			lastKeySize > 0
+				? store.readKey(getManyBytes, position + 4, position + 4 + lastKeySize)
+				: undefined;
+		result.minKey = reverse ? lastKey : firstKey;
+		result.maxKey = reverse ? firstKey : lastKey;
+	}
+	if (valueType) {
+		let numbers = getManyView.getFloat64(24, isLittleEndian);
+		result.valueCount = numbers;
+		result.sum = getManyView.getFloat64(32, isLittleEndian);
+		if (numbers > 0) {
+			result.min = getManyView.getFloat64(40, isLittleEndian);
+			result.max = getManyView.getFloat64(48, isLittleEndian);
+		}
+	}
+	return result;
+}
+const GET_MANY_HEADER_SIZE = 16;
+const GET_MANY_NOT_FOUND = 1;
+const GET_MANY_INDIVIDUALLY = 2;
+const GET_MANY_SORTED = 1;
+const GET_MANY_BUFFER_SIZE = 0x10000;
+const MAX_GET_MANY_BUFFER_SIZE = 0x400000;
+let getManyBytes, getManyView;
+function allocateGetManyBuffer(size) {
+	getManyBytes =
+		typeof Buffer != 'undefined'
+			? Buffer.allocUnsafeSlow(size)
+			: new Uint8Array(size);
+	getManyBytes.address =
+		getAddress(getManyBytes.buffer) + getManyBytes.byteOffset;
+	getManyView = new DataView(
+		getManyBytes.buffer,
+		getManyBytes.byteOffset,
+		getManyBytes.byteLength,
+	);
+}
 export function makeReusableBuffer(size) {
 	let bytes =
 		typeof Buffer != 'undefined' ? Buffer.alloc(size) : new Uint8Array(size);
@@ -1231,8 +1816,26 @@ if (!addReadCallback) {
 		readCallbacks.set(callbackId, callback);
 		return callbackId;
 	};
-	setReadCallback(function (callbackId) {
-		readCallbacks.get(callbackId)();
-		readCallbacks.delete(callbackId);
-	});
+	// completed reads are delivered in batches, with the callback ids written to this buffer
+	let completedReads = new Uint32Array(1024);
+	setReadCallback(function (count) {
+		let error;
+		for (let i = 0; i < count; i++) {
+			let callbackId = completedReads[i];
+			let callback = readCallbacks.get(callbackId);
+			readCallbacks.delete(callbackId);
+			try {
+				callback();
+			} catch (callbackError) {
+				// don't let one failed callback prevent the rest of the batch from completing
+				error = callbackError;
+			}
+		}
+		// reported asynchronously, since throwing here would leave an exception pending for the rest of the chunks in
+		// this delivery, and their callbacks would never be called
+		if (error)
+			queueMicrotask(() => {
+				throw error;
+			});
+	}, completedReads);
 }
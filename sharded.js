@@ -0,0 +1,309 @@
+import { ExtendedIterable } from '@harperfast/extended-iterable';
+import { orderedBinary } from './native.js';
+import { open } from './open.js';
+
+/*
+	A sharded database spreads its entries across several database environments (shards), with each key routed to
+	one shard. Each environment has its own write thread, so writes to different shards are committed in parallel.
+	Reads of a key go to its shard, and range queries are a merge of the (ordered) ranges of all the shards.
+*/
+export function openSharded(path, options) {
+	if (typeof path == 'object' && !options) {
+		options = path;
+		path = options.path;
+	}
+	options = Object.assign({}, options);
+	let count = options.shards || 4;
+	let shardKey = options.shardKey;
+	let shardRanges = options.shardRanges;
+	if (shardRanges) count = shardRanges.length + 1;
+	delete options.shards;
+	delete options.shardKey;
+	delete options.shardRanges;
+	let compare =
+		options.keyEncoding == 'uint32' ? (a, b) => a - b : compareShardKeys;
+	let route;
+	if (shardKey) route = shardKey;
+	else if (shardRanges) {
+		// each shard holds the keys from the previous boundary (inclusive) to its boundary (exclusive)
+		route = (key) => {
+			let low = 0,
+				high = shardRanges.length;
+			while (low < high) {
+				let middle = (low + high) >> 1;
+				if (compare(key, shardRanges[middle]) < 0) high = middle;
+				else low = middle + 1;
+			}
+			return low;
+		};
+	} else route = (key) => hashKey(key) % count;
+	let shards = [];
+	try {
+		for (let i = 0; i < count; i++)
+			shards.push(
+				open(shardPath(path, i), Object.assign({}, options, { path: undefined })),
+			);
+	} catch (error) {
+		for (let shard of shards) shard.close();
+		throw error;
+	}
+	return new ShardedStore(shards, shards, route, compare);
+}
+
+function shardPath(path, index) {
+	if (path == null) return path; // temporary databases
+	let extension = path.match(/\.mdb$/);
+	return extension
+		? path.slice(0, -4) + '-' + index + '.mdb'
+		: path + '-' + index;
+}
+
+function compareShardKeys(a, b) {
+	if (a instanceof Uint8Array && b instanceof Uint8Array)
+		return Buffer.compare(a, b);
+	return orderedBinary.compareKeys(a, b);
+}
+
+// FNV-1a of the binary form of the key
+function hashKey(key) {
+	let bytes =
+		key instanceof Uint8Array ? key : orderedBinary.toBufferKey(key);
+	let hash = 0x811c9dc5;
+	for (let i = 0, l = bytes.length; i < l; i++) {
+		hash ^= bytes[i];
+		hash = Math.imul(hash, 0x01000193);
+	}
+	return hash >>> 0;
+}
+
+class ShardedStore {
+	constructor(roots, stores, route, compare) {
+		this.roots = roots;
+		this.shards = stores;
+		this.route = route;
+		this.compare = compare;
+	}
+	getShardIndex(key) {
+		let index = this.route(key);
+		if (!(index >= 0 && index < this.shards.length))
+			throw new Error('Invalid shard ' + index + ' for key ' + key);
+		return index;
+	}
+	getShard(key) {
+		return this.shards[this.getShardIndex(key)];
+	}
+	openDB(name, dbOptions) {
+		if (typeof name == 'object' && !dbOptions) {
+			dbOptions = name;
+			name = dbOptions.name;
+		}
+		return new ShardedStore(
+			this.roots,
+			this.roots.map((root) => root.openDB(name, Object.assign({}, dbOptions))),
+			this.route,
+			dbOptions?.keyEncoding == 'uint32' ? (a, b) => a - b : compareShardKeys,
+		);
+	}
+	get(key, options) {
+		return this.getShard(key).get(key, options);
+	}
+	getEntry(key, options) {
+		return this.getShard(key).getEntry(key, options);
+	}
+	getBinary(key, options) {
+		return this.getShard(key).getBinary(key, options);
+	}
+	doesExist(key, versionOrValue) {
+		return this.getShard(key).doesExist(key, versionOrValue);
+	}
+	getValues(key, options) {
+		return this.getShard(key).getValues(key, options);
+	}
+	getManySync(keys, options) {
+		return keys.map((key) => this.get(key, options));
+	}
+	async getMany(keys, callback) {
+		// look up the keys of each shard together
+		let shardKeys = this.shards.map(() => []);
+		let positions = this.shards.map(() => []);
+		keys.forEach((key, i) => {
+			let index = this.getShardIndex(key);
+			shardKeys[index].push(key);
+			positions[index].push(i);
+		});
+		let results = new Array(keys.length);
+		try {
+			await Promise.all(
+				this.shards.map(async (shard, index) => {
+					if (shardKeys[index].length === 0) return;
+					let values = await shard.getMany(shardKeys[index]);
+					positions[index].forEach(
+						(position, i) => (results[position] = values[i]),
+					);
+				}),
+			);
+		} catch (error) {
+			if (callback) return callback(error);
+			throw error;
+		}
+		if (callback) callback(null, results);
+		return results;
+	}
+	put(key, value, versionOrOptions, ifVersion) {
+		return this.getShard(key).put(key, value, versionOrOptions, ifVersion);
+	}
+	putSync(key, value, versionOrOptions, ifVersion) {
+		return this.getShard(key).putSync(
+			key,
+			value,
+			versionOrOptions,
+			ifVersion,
+		);
+	}
+	remove(key, ifVersionOrValue, callback) {
+		return this.getShard(key).remove(key, ifVersionOrValue, callback);
+	}
+	del(key, options, callback) {
+		return this.remove(key, options, callback);
+	}
+	removeSync(key, ifVersionOrValue) {
+		return this.getShard(key).removeSync(key, ifVersionOrValue);
+	}
+	ifVersion(key, version, callback, options) {
+		// the conditional writes must be for keys in the same shard
+		return this.getShard(key).ifVersion(key, version, callback, options);
+	}
+	getRange(options) {
+		if (!options) options = {};
+		let offset = options.offset || 0;
+		let limit = options.limit;
+		let includeValues = options.values !== false;
+		let reverse = options.reverse;
+		// each shard needs to provide enough entries to cover the offset
+		let shardOptions = Object.assign({}, options, {
+			offset: undefined,
+			limit: limit === undefined ? undefined : offset + limit,
+		});
+		let shards = this.shards;
+		let compare = reverse ? (a, b) => this.compare(b, a) : this.compare;
+		return new ExtendedIterable({
+			*[Symbol.iterator]() {
+				let merged = mergeRanges(
+					shards.map((shard) => shard.getRange(shardOptions)),
+					includeValues ? (a, b) => compare(a.key, b.key) : compare,
+				);
+				let skip = offset,
+					count = 0;
+				for (let entry of merged) {
+					if (skip > 0) {
+						skip--;
+						continue;
+					}
+					if (limit !== undefined && count++ >= limit) return;
+					yield entry;
+				}
+			},
+		});
+	}
+	getKeys(options) {
+		return this.getRange(Object.assign({}, options, { values: false }));
+	}
+	getCount(options) {
+		let count = 0;
+		let shardOptions = Object.assign({}, options, {
+			offset: undefined,
+			limit: undefined,
+		});
+		for (let shard of this.shards) count += shard.getCount(shardOptions);
+		if (options?.offset) count = Math.max(0, count - options.offset);
+		if (options?.limit !== undefined) count = Math.min(count, options.limit);
+		return count;
+	}
+	getStats() {
+		let shards = this.shards.map((shard) => shard.getStats());
+		return {
+			entryCount: shards.reduce(
+				(total, stats) => total + stats.entryCount,
+				0,
+			),
+			shards,
+		};
+	}
+	clearAsync() {
+		return Promise.all(this.shards.map((shard) => shard.clearAsync()));
+	}
+	clearSync() {
+		for (let shard of this.shards) shard.clearSync();
+	}
+	drop() {
+		return Promise.all(this.shards.map((shard) => shard.drop()));
+	}
+	get committed() {
+		return Promise.all(this.shards.map((shard) => shard.committed));
+	}
+	get flushed() {
+		return Promise.all(this.shards.map((shard) => shard.flushed));
+	}
+	close() {
+		return Promise.all(this.shards.map((shard) => shard.close()));
+	}
+}
+
+/*
+	K-way merge of ordered ranges, using a binary heap of the next entry from each range.
+*/
+function* mergeRanges(ranges, compare) {
+	let iterators = ranges.map((range) => range[Symbol.iterator]());
+	let heap = [];
+	try {
+		for (let iterator of iterators) {
+			let result = iterator.next();
+			if (!result.done) push({ entry: result.value, iterator });
+		}
+		while (heap.length > 0) {
+			let top = heap[0];
+			yield top.entry;
+			let result = top.iterator.next();
+			if (result.done) {
+				let last = heap.pop();
+				if (heap.length > 0) {
+					heap[0] = last;
+					siftDown(0);
+				}
+			} else {
+				top.entry = result.value;
+				siftDown(0);
+			}
+		}
+	} finally {
+		// release the cursors of ranges that weren't finished
+		for (let iterator of iterators) if (iterator.return) iterator.return();
+	}
+	function push(item) {
+		let i = heap.push(item) - 1;
+		while (i > 0) {
+			let parent = (i - 1) >> 1;
+			if (compare(heap[parent].entry, item.entry) <= 0) break;
+			heap[i] = heap[parent];
+			i = parent;
+		}
+		heap[i] = item;
+	}
+	function siftDown(i) {
+		let item = heap[i];
+		let length = heap.length;
+		while (true) {
+			let child = (i << 1) + 1;
+			if (child >= length) break;
+			if (
+				child + 1 < length &&
+				compare(heap[child + 1].entry, heap[child].entry) < 0
+			)
+				child++;
+			if (compare(item.entry, heap[child].entry) <= 0) break;
+			heap[i] = heap[child];
+			i = child;
+		}
+		heap[i] = item;
+	}
+}
@@ -1,15 +1,39 @@
 #include "lz4.h"
+#include "lz4hc.h"
 #include "lmdb-js.h"
 #include <atomic>
+#include <thread>
+#ifdef USE_ZSTD
+#include <zstd.h>
+#include <zdict.h>
+#endif
 
 using namespace Napi;
 
 thread_local LZ4_stream_t* Compression::stream = nullptr;
+static thread_local LZ4_streamHC_t* streamHC = nullptr;
+#ifdef USE_ZSTD
+static thread_local ZSTD_CCtx* zstdCompressContext = nullptr;
+static thread_local ZSTD_DCtx* zstdDecompressContext = nullptr;
+#endif
+/*
+	The status byte (at the starting offset) of a compressed value identifies the codec and header: 254 is LZ4 with a
+	3-byte length, 255 is LZ4 with a long length, and 253 is zstd with a long length (LZ4HC output is plain LZ4 data).
+	252 (LZ4) and 251 (zstd) are compressed with a versioned dictionary, with the id of the dictionary in the second
+	byte, so records can always be decompressed with the dictionary they were written with.
+*/
+const uint8_t LZ4_STATUS = 254;
+const uint8_t LZ4_LONG_STATUS = 255;
+const uint8_t ZSTD_STATUS = 253;
+const uint8_t LZ4_DICTIONARY_STATUS = 252;
+const uint8_t ZSTD_DICTIONARY_STATUS = 251;
 Compression::Compression(const CallbackInfo& info) : ObjectWrap<Compression>(info) {
 	unsigned int compressionThreshold = 1000;
 	char* dictionary = nullptr;
 	size_t dictSize = 0;
 	unsigned int startingOffset = 0;
+	CompressionCodec codec = CompressionCodec::LZ4;
+	int level = 0;
 	if (info[0].IsObject()) {
 		auto dictionaryOption = info[0].As<Object>().Get("dictionary");
 		if (!dictionaryOption.IsUndefined()) {
@@ -20,16 +44,62 @@ Compression::Compression(const CallbackInfo& info) : ObjectWrap<Compression>(inf
 			napi_get_buffer_info(info.Env(), dictionaryOption, (void**) &dictionary, &dictSize);
 			dictSize = (dictSize >> 3) << 3; // make sure it is word-aligned
 		}
+		auto dictionariesOption = info[0].As<Object>().Get("dictionaries");
+		if (dictionariesOption.IsArray()) {
+			Array dictionaries = dictionariesOption.As<Array>();
+			if (dictionaries.Length() > 255) {
+				throwError(info.Env(), "No more than 255 versioned dictionaries can be used");
+				return;
+			}
+			for (uint32_t i = 0; i < dictionaries.Length(); i++) {
+				Napi::Value versionedDictionary = dictionaries.Get(i);
+				if (!versionedDictionary.IsTypedArray()) {
+					throwError(info.Env(), "Dictionary must be a buffer");
+					return;
+				}
+				MDB_val entry;
+				napi_get_buffer_info(info.Env(), versionedDictionary, &entry.mv_data, &entry.mv_size);
+				this->dictionaries.push_back(entry);
+			}
+		}
 		auto thresholdOption = info[0].As<Object>().Get("threshold");
 		if (thresholdOption.IsNumber())
 			compressionThreshold = thresholdOption.As<Number>();
 		auto offsetOption = info[0].As<Object>().Get("startingOffset");
 		if (offsetOption.IsNumber())
 			startingOffset = offsetOption.As<Number>();
+		auto codecOption = info[0].As<Object>().Get("codec");
+		if (codecOption.IsString()) {
+			std::string codecName = codecOption.As<String>().Utf8Value();
+			if (codecName == "lz4hc")
+				codec = CompressionCodec::LZ4HC;
+			else if (codecName == "zstd") {
+#ifdef USE_ZSTD
+				codec = CompressionCodec::ZSTD;
+#else
+				throwError(info.Env(), "zstd compression is not available in this build (build with LMDB_ZSTD=true)");
+				return;
+#endif
+			} else if (codecName != "lz4") {
+				throwError(info.Env(), "Unknown compression codec");
+				return;
+			}
+		}
+		auto levelOption = info[0].As<Object>().Get("level");
+		if (levelOption.IsNumber())
+			level = levelOption.As<Number>();
 	}
+	this->codec = codec;
+	this->level = level;
 	this->startingOffset = startingOffset;
 	this->dictionary = this->compressDictionary = dictionary;
-	this->dictionarySize = dictSize;
+	this->dictionarySize = this->compressDictionarySize = dictSize;
+	// new records are compressed with the latest versioned dictionary (the buffers are kept referenced by the JS object)
+	this->dictionaryId = this->dictionaries.size();
+	if (this->dictionaryId) {
+		this->compressDictionary = (char*) this->dictionaries.back().mv_data;
+		this->compressDictionarySize = this->dictionaries.back().mv_size;
+	}
 	this->decompressTarget = dictionary + dictSize;
 	this->decompressSize = 0;
 	this->acceleration = 1;
@@ -47,18 +117,17 @@ Napi::Value Compression::setBuffer(const CallbackInfo& info) {
 	napi_get_buffer_info(info.Env(), info[3], (void**) &this->dictionary, &length);
 	return info.Env().Undefined();
 }
-void Compression::decompress(MDB_val& data, bool &isValid, bool canAllocate) {
-	uint32_t uncompressedLength;
+/*
+	Reads the header of a compressed value, returning the size of the header (0 if it is not valid), along with the
+	uncompressed length and the dictionary that it was compressed with.
+*/
+int Compression::readHeader(unsigned char* charData, uint32_t& uncompressedLength, char*& decompressDictionary, size_t& decompressDictionarySize) {
 	int compressionHeaderSize;
-	uint32_t compressedLength = data.mv_size;
-	void* originalData = data.mv_data;
-	unsigned char* charData = (unsigned char*) data.mv_data + startingOffset;
-
-	if (charData[0] == 254) {
+	if (charData[0] == LZ4_STATUS) {
 		uncompressedLength = ((uint32_t)charData[1] << 16) | ((uint32_t)charData[2] << 8) | (uint32_t)charData[3];
 		compressionHeaderSize = 4;
 	}
-	else if (charData[0] == 255) {
+	else if (charData[0] >= ZSTD_DICTIONARY_STATUS) {
 		uncompressedLength = ((uint32_t)charData[4] << 24) | ((uint32_t)charData[5] << 16) | ((uint32_t)charData[6] << 8) | (uint32_t)charData[7];
 		compressionHeaderSize = 8;
 	}
@@ -66,6 +135,31 @@ void Compression::decompress(MDB_val& data, bool &isValid, bool canAllocate) {
 		fprintf(stderr, "Unknown status byte %u\n", charData[0]);
 		//if (canAllocate)
 		//	Nan::ThrowError("Unknown status byte");
+		return 0;
+	}
+	decompressDictionary = dictionary;
+	decompressDictionarySize = dictionarySize;
+	if (charData[0] == LZ4_DICTIONARY_STATUS || charData[0] == ZSTD_DICTIONARY_STATUS) {
+		unsigned int id = charData[1];
+		if (id == 0 || id > dictionaries.size()) {
+			fprintf(stderr, "Unknown compression dictionary %u\n", id);
+			return 0;
+		}
+		decompressDictionary = (char*) dictionaries[id - 1].mv_data;
+		decompressDictionarySize = dictionaries[id - 1].mv_size;
+	}
+	return compressionHeaderSize;
+}
+
+void Compression::decompress(MDB_val& data, bool &isValid, bool canAllocate) {
+	uint32_t uncompressedLength;
+	uint32_t compressedLength = data.mv_size;
+	void* originalData = data.mv_data;
+	unsigned char* charData = (unsigned char*) data.mv_data + startingOffset;
+	char* decompressDictionary;
+	size_t decompressDictionarySize;
+	int compressionHeaderSize = readHeader(charData, uncompressedLength, decompressDictionary, decompressDictionarySize);
+	if (!compressionHeaderSize) {
 		isValid = false;
 		return;
 	}
@@ -77,26 +171,183 @@ void Compression::decompress(MDB_val& data, bool &isValid, bool canAllocate) {
 		isValid = false;
 		return;
 	}
-	int written = LZ4_decompress_safe_usingDict(
-		(char*)charData + compressionHeaderSize, decompressTarget + startingOffset,
-		compressedLength - compressionHeaderSize - startingOffset, decompressSize - startingOffset,
-		dictionary, dictionarySize);
-	//fprintf(stdout, "first uncompressed byte %X %X %X %X %X %X\n", uncompressedData[0], uncompressedData[1], uncompressedData[2], uncompressedData[3], uncompressedData[4], uncompressedData[5]);
-	if (written < 0) {
-		fprintf(stderr, "Failed to decompress data %u %u bytes:\n", compressionHeaderSize, uncompressedLength);
-		for (uint32_t i = 0; i < compressedLength; i++) {
-			fprintf(stderr, "%u ", charData[i]);
+	if (charData[0] == ZSTD_STATUS || charData[0] == ZSTD_DICTIONARY_STATUS) {
+#ifdef USE_ZSTD
+		if (!zstdDecompressContext)
+			zstdDecompressContext = ZSTD_createDCtx();
+		size_t written = ZSTD_decompress_usingDict(zstdDecompressContext,
+			decompressTarget + startingOffset, decompressSize - startingOffset,
+			charData + compressionHeaderSize, compressedLength - compressionHeaderSize - startingOffset,
+			decompressDictionary, decompressDictionarySize);
+		if (ZSTD_isError(written) || written != uncompressedLength) {
+			fprintf(stderr, "Failed to decompress zstd data: %s\n", ZSTD_isError(written) ? ZSTD_getErrorName(written) : "wrong length");
+			isValid = false;
+			return;
 		}
-		//if (canAllocate)
-		//	Nan::ThrowError("Failed to decompress data");
+#else
+		fprintf(stderr, "Can not decompress zstd data, this build does not include zstd\n");
 		isValid = false;
 		return;
+#endif
+	} else {
+		int written = LZ4_decompress_safe_usingDict(
+			(char*)charData + compressionHeaderSize, decompressTarget + startingOffset,
+			compressedLength - compressionHeaderSize - startingOffset, decompressSize - startingOffset,
+			decompressDictionary, decompressDictionarySize);
+		//fprintf(stdout, "first uncompressed byte %X %X %X %X %X %X\n", uncompressedData[0], uncompressedData[1], uncompressedData[2], uncompressedData[3], uncompressedData[4], uncompressedData[5]);
+		if (written < 0) {
+			fprintf(stderr, "Failed to decompress data %u %u bytes:\n", compressionHeaderSize, uncompressedLength);
+			for (uint32_t i = 0; i < compressedLength; i++) {
+				fprintf(stderr, "%u ", charData[i]);
+			}
+			//if (canAllocate)
+			//	Nan::ThrowError("Failed to decompress data");
+			isValid = false;
+			return;
+		}
 	}
 	if (startingOffset)
 		memcpy(decompressTarget, originalData, startingOffset);
 	isValid = true;
 }
 
+/*
+	Decompresses a value into the given target (instead of the shared decompression target), which can be sized for the
+	value, or smaller, to only decompress the first targetSize bytes of the value (like reading just a header), since
+	decompression can stop once the target is filled. Returns the number of bytes written, or -1 if the value could not
+	be decompressed, and sets the full (uncompressed) size of the value.
+*/
+int64_t Compression::decompressInto(MDB_val& data, char* target, size_t targetSize, size_t& fullSize) {
+	uint32_t uncompressedLength;
+	unsigned char* charData = (unsigned char*) data.mv_data + startingOffset;
+	char* decompressDictionary;
+	size_t decompressDictionarySize;
+	int compressionHeaderSize = readHeader(charData, uncompressedLength, decompressDictionary, decompressDictionarySize);
+	if (!compressionHeaderSize)
+		return -1;
+	fullSize = uncompressedLength + startingOffset;
+	size_t prefixSize = std::min((size_t) startingOffset, targetSize);
+	memcpy(target, data.mv_data, prefixSize);
+	if (targetSize <= startingOffset)
+		return prefixSize;
+	char* source = (char*) charData + compressionHeaderSize;
+	size_t sourceSize = data.mv_size - compressionHeaderSize - startingOffset;
+	size_t capacity = targetSize - startingOffset;
+	size_t wanted = std::min(capacity, (size_t) uncompressedLength);
+	target += startingOffset;
+	if (charData[0] == ZSTD_STATUS || charData[0] == ZSTD_DICTIONARY_STATUS) {
+#ifdef USE_ZSTD
+		if (!zstdDecompressContext)
+			zstdDecompressContext = ZSTD_createDCtx();
+		size_t written;
+		if (wanted == uncompressedLength) {
+			written = ZSTD_decompress_usingDict(zstdDecompressContext, target, capacity,
+				source, sourceSize, decompressDictionary, decompressDictionarySize);
+		} else {
+			// stream the decompression, stopping when the target is filled
+			ZSTD_DCtx_reset(zstdDecompressContext, ZSTD_reset_session_only);
+			written = ZSTD_DCtx_loadDictionary(zstdDecompressContext, decompressDictionary, decompressDictionarySize);
+			ZSTD_outBuffer output = { target, wanted, 0 };
+			ZSTD_inBuffer input = { source, sourceSize, 0 };
+			while (!ZSTD_isError(written) && output.pos < output.size && input.pos < input.size)
+				written = ZSTD_decompressStream(zstdDecompressContext, &output, &input);
+			if (!ZSTD_isError(written))
+				written = output.pos;
+			ZSTD_DCtx_reset(zstdDecompressContext, ZSTD_reset_session_and_parameters);
+		}
+		if (ZSTD_isError(written) || written != wanted)
+			return -1;
+#else
+		return -1;
+#endif
+	} else {
+		int written = LZ4_decompress_safe_partial_usingDict(source, target, sourceSize, wanted, capacity,
+			decompressDictionary, decompressDictionarySize);
+		if (written < 0 || (size_t) written != wanted)
+			return -1;
+	}
+	return wanted + startingOffset;
+}
+
+/*
+	Compressed values are written into per-thread arenas rather than individually allocated, since a write batch can have
+	thousands of compressed values that would otherwise each be allocated by a compression thread and freed by the write
+	thread (contending on the allocator). Each allocation is preceded by a header with its arena (null if it was
+	allocated on the heap) and size, and the write thread releases it by adding its size to the arena's released count.
+	Only the owning thread allocates from an arena, and it resets the arena once everything in it has been released.
+*/
+struct CompressionArena {
+	char* memory;
+	size_t used; // only accessed by the owning thread
+	std::atomic<size_t> released;
+	CompressionArena* next;
+};
+const size_t COMPRESSION_ARENA_SIZE = 0x100000;
+const int MAX_COMPRESSION_ARENAS = 8; // per thread, beyond this (or for large values) we allocate from the heap
+const size_t ALLOCATION_HEADER_SIZE = 16;
+static thread_local CompressionArena* arenas = nullptr;
+static thread_local CompressionArena* currentArena = nullptr;
+
+char* Compression::allocateCompressed(size_t size) {
+	size_t allocationSize = (size + ALLOCATION_HEADER_SIZE + 7) & ~7;
+	CompressionArena* arena = currentArena;
+	char* header;
+	if (allocationSize <= (COMPRESSION_ARENA_SIZE >> 2)) {
+		if (!arena || arena->used + allocationSize > COMPRESSION_ARENA_SIZE) {
+			arena = nullptr;
+			int count = 0;
+			for (CompressionArena* candidate = arenas; candidate; candidate = candidate->next) {
+				count++;
+				if (candidate->released.load(std::memory_order_acquire) == candidate->used) {
+					// everything has been released, so nothing else is accessing this arena
+					candidate->used = 0;
+					candidate->released.store(0, std::memory_order_relaxed);
+					arena = candidate;
+					break;
+				}
+			}
+			if (!arena && count < MAX_COMPRESSION_ARENAS) {
+				arena = new CompressionArena();
+				arena->memory = new char[COMPRESSION_ARENA_SIZE];
+				arena->used = 0;
+				arena->released = 0;
+				arena->next = arenas;
+				arenas = arena;
+			}
+			currentArena = arena;
+		}
+	} else
+		arena = nullptr;
+	if (arena) {
+		header = arena->memory + arena->used;
+		arena->used += allocationSize;
+	} else
+		header = new char[allocationSize];
+	*((CompressionArena**) header) = arena;
+	*((size_t*) (header + 8)) = allocationSize;
+	return header + ALLOCATION_HEADER_SIZE;
+}
+
+void Compression::trimCompressed(char* data, size_t size) {
+	// give back the unused end of the most recent allocation of this thread
+	char* header = data - ALLOCATION_HEADER_SIZE;
+	CompressionArena* arena = *((CompressionArena**) header);
+	size_t allocationSize = (size + ALLOCATION_HEADER_SIZE + 7) & ~7;
+	if (arena && arena == currentArena && header + *((size_t*) (header + 8)) == arena->memory + arena->used) {
+		arena->used -= *((size_t*) (header + 8)) - allocationSize;
+		*((size_t*) (header + 8)) = allocationSize;
+	}
+}
+
+void Compression::releaseCompressed(void* data) {
+	char* header = (char*) data - ALLOCATION_HEADER_SIZE;
+	CompressionArena* arena = *((CompressionArena**) header);
+	if (arena)
+		arena->released.fetch_add(*((size_t*) (header + 8)), std::memory_order_release);
+	else
+		delete[] header;
+}
+
 int Compression::compressInstruction(EnvWrap* env, double* compressionAddress) {
 	MDB_val value;
 	value.mv_data = (void*)((size_t) * (compressionAddress - 1));
@@ -121,84 +372,320 @@ int Compression::compressInstruction(EnvWrap* env, double* compressionAddress) {
 }
 
 argtokey_callback_t Compression::compress(MDB_val* value, void (*freeValue)(MDB_val&)) {
-	size_t dataLength = value->mv_size - startingOffset;
 	char* data = (char*)value->mv_data;
 	if (value->mv_size < compressionThreshold && !(value->mv_size > startingOffset && ((uint8_t*)data)[startingOffset] >= 250))
 		return freeValue; // don't compress if less than threshold (but we must compress if the first byte is the compression indicator)
-	bool longSize = dataLength >= 0x1000000;
-	int prefixSize = (longSize ? 8 : 4) + startingOffset;
-	int maxCompressedSize = LZ4_COMPRESSBOUND(dataLength);
-	char* compressed = new char[maxCompressedSize + prefixSize];
+	size_t maxCompressedSize = compressedBound(value->mv_size);
+	char* compressed = allocateCompressed(maxCompressedSize);
 	//fprintf(stdout, "compressing %u\n", dataLength);
-	if (!stream)
-		stream = LZ4_createStream();
-	LZ4_loadDict(stream, compressDictionary, dictionarySize);
-	int compressedSize = LZ4_compress_fast_continue(stream, data + startingOffset, compressed + prefixSize, dataLength, maxCompressedSize, acceleration);
+	size_t compressedSize = compressInto(data, value->mv_size, compressed, maxCompressedSize);
 	if (compressedSize > 0) {
-		if (startingOffset > 0) // copy the uncompressed prefix
-			memcpy(compressed, data, startingOffset);
 		if (freeValue)
 			freeValue(*value);
-		uint8_t* compressedData = (uint8_t*)compressed + startingOffset;
-		if (longSize) {
-			compressedData[0] = 255;
-			compressedData[2] = (uint8_t)(dataLength >> 40u);
-			compressedData[3] = (uint8_t)(dataLength >> 32u);
-			compressedData[4] = (uint8_t)(dataLength >> 24u);
-			compressedData[5] = (uint8_t)(dataLength >> 16u);
-			compressedData[6] = (uint8_t)(dataLength >> 8u);
-			compressedData[7] = (uint8_t)dataLength;
-		}
-		else {
-			compressedData[0] = 254;
-			compressedData[1] = (uint8_t)(dataLength >> 16u);
-			compressedData[2] = (uint8_t)(dataLength >> 8u);
-			compressedData[3] = (uint8_t)dataLength;
-		}
-		value->mv_size = compressedSize + prefixSize;
+		value->mv_size = compressedSize;
 		value->mv_data = compressed;
+		trimCompressed(compressed, value->mv_size);
 		return ([](MDB_val &value) -> void {
-			delete[] (char*)value.mv_data;
+			releaseCompressed(value.mv_data);
 		});
 	}
 	else {
-		delete[] compressed;
+		releaseCompressed(compressed);
 		return nullptr;
 	}
 }
 
-class CompressionWorker : public AsyncWorker {
-  public:
-	CompressionWorker(EnvWrap* env, double* compressionAddress, const Function& callback)
-	  : AsyncWorker(callback), env(env), compressionAddress(compressionAddress) {}
+size_t Compression::compressedBound(size_t size) {
+	size_t dataLength = size - startingOffset;
+	bool longSize = dataLength >= 0x1000000 || codec == CompressionCodec::ZSTD || dictionaryId;
+#ifdef USE_ZSTD
+	if (codec == CompressionCodec::ZSTD)
+		return ZSTD_compressBound(dataLength) + 8 + startingOffset;
+#endif
+	return LZ4_COMPRESSBOUND(dataLength) + (longSize ? 8 : 4) + startingOffset;
+}
 
+/*
+	Compresses the value (with its header) into the target, which can be any memory, including reserved space in a
+	database page. The target should be at least compressedBound(size) bytes. Returns the size of the compressed value
+	(including the header), or 0 if it could not be compressed.
+*/
+size_t Compression::compressInto(char* data, size_t size, char* target, size_t targetSize) {
+	size_t dataLength = size - startingOffset;
+	bool longSize = dataLength >= 0x1000000 || codec == CompressionCodec::ZSTD || dictionaryId;
+	int prefixSize = (longSize ? 8 : 4) + startingOffset;
+	if (targetSize <= (size_t) prefixSize)
+		return 0;
+	size_t maxCompressedSize = targetSize - prefixSize;
+	size_t compressedSize;
+	switch (codec) {
+#ifdef USE_ZSTD
+		case CompressionCodec::ZSTD: {
+			if (!zstdCompressContext)
+				zstdCompressContext = ZSTD_createCCtx();
+			compressedSize = ZSTD_compress_usingDict(zstdCompressContext, target + prefixSize, maxCompressedSize,
+				data + startingOffset, dataLength, compressDictionary, compressDictionarySize,
+				level ? level : ZSTD_CLEVEL_DEFAULT);
+			if (ZSTD_isError(compressedSize))
+				compressedSize = 0;
+			break;
+		}
+#endif
+		case CompressionCodec::LZ4HC: {
+			if (!streamHC)
+				streamHC = LZ4_createStreamHC();
+			LZ4_resetStreamHC_fast(streamHC, level ? level : LZ4HC_CLEVEL_DEFAULT);
+			LZ4_loadDictHC(streamHC, compressDictionary, compressDictionarySize);
+			int written = LZ4_compress_HC_continue(streamHC, data + startingOffset, target + prefixSize, dataLength, maxCompressedSize);
+			compressedSize = written > 0 ? written : 0;
+			break;
+		}
+		default: {
+			if (!stream)
+				stream = LZ4_createStream();
+			LZ4_loadDict(stream, compressDictionary, compressDictionarySize);
+			int written = LZ4_compress_fast_continue(stream, data + startingOffset, target + prefixSize, dataLength, maxCompressedSize, acceleration);
+			compressedSize = written > 0 ? written : 0;
+		}
+	}
+	if (compressedSize == 0)
+		return 0;
+	if (startingOffset > 0) // copy the uncompressed prefix
+		memcpy(target, data, startingOffset);
+	uint8_t* compressedData = (uint8_t*)target + startingOffset;
+	if (longSize) {
+		if (dictionaryId)
+			compressedData[0] = codec == CompressionCodec::ZSTD ? ZSTD_DICTIONARY_STATUS : LZ4_DICTIONARY_STATUS;
+		else
+			compressedData[0] = codec == CompressionCodec::ZSTD ? ZSTD_STATUS : LZ4_LONG_STATUS;
+		compressedData[1] = dictionaryId;
+		compressedData[2] = (uint8_t)(dataLength >> 40u);
+		compressedData[3] = (uint8_t)(dataLength >> 32u);
+		compressedData[4] = (uint8_t)(dataLength >> 24u);
+		compressedData[5] = (uint8_t)(dataLength >> 16u);
+		compressedData[6] = (uint8_t)(dataLength >> 8u);
+		compressedData[7] = (uint8_t)dataLength;
+	}
+	else {
+		compressedData[0] = LZ4_STATUS;
+		compressedData[1] = (uint8_t)(dataLength >> 16u);
+		compressedData[2] = (uint8_t)(dataLength >> 8u);
+		compressedData[3] = (uint8_t)dataLength;
+	}
+	return compressedSize + prefixSize;
+}
 
-	void Execute() {
-		uint64_t compressionPointer;
-		compressionPointer = std::atomic_exchange((std::atomic<int64_t>*) compressionAddress, (int64_t) 2);
-		if (compressionPointer > 1) {
-			Compression* compression = (Compression*)(size_t) * ((double*)&compressionPointer);
-			compression->compressInstruction(env, compressionAddress);
+/*
+	Builds a dictionary from sample values. With zstd, this uses zstd's own trainer. Otherwise (and if zstd training fails,
+	which it can with too few samples), this picks the segments of the samples that contain the most d-mers (short
+	substrings) that are shared across many samples, similar to zstd's COVER algorithm. LZ4 dictionaries are simply raw
+	content, so the most valuable segments are placed at the end, closest to the data being compressed.
+*/
+size_t Compression::trainDictionary(const char* samples, const std::vector<size_t>& sampleSizes, char* target, size_t targetSize, CompressionCodec codec) {
+#ifdef USE_ZSTD
+	if (codec == CompressionCodec::ZSTD) {
+		size_t size = ZDICT_trainFromBuffer(target, targetSize, samples, sampleSizes.data(), sampleSizes.size());
+		if (!ZDICT_isError(size))
+			return size;
+	}
+#endif
+	const size_t DMER_SIZE = 8;
+	const size_t SEGMENT_SIZE = 64;
+	const int HASH_BITS = 20;
+	// count the number of samples that each d-mer occurs in, in an approximate (hashed) table
+	std::vector<uint32_t> frequencies(1 << HASH_BITS);
+	std::vector<uint32_t> lastSample(1 << HASH_BITS);
+	auto dmerHash = [&](const char* position) -> uint32_t {
+		uint64_t dmer;
+		memcpy(&dmer, position, DMER_SIZE);
+		return (uint32_t) ((dmer * 0x9E3779B185EBCA87ull) >> (64 - HASH_BITS));
+	};
+	const char* sample = samples;
+	for (size_t i = 0; i < sampleSizes.size(); i++) {
+		for (size_t j = 0; j + DMER_SIZE <= sampleSizes[i]; j++) {
+			uint32_t hash = dmerHash(sample + j);
+			if (lastSample[hash] != i + 1) {
+				lastSample[hash] = i + 1;
+				frequencies[hash]++;
+			}
+		}
+		sample += sampleSizes[i];
+	}
+	// score each segment by the d-mers in it that occur in more than one sample
+	struct Segment {
+		const char* start;
+		size_t size;
+		uint64_t score;
+	};
+	auto scoreSegment = [&](const char* start, size_t size) -> uint64_t {
+		uint64_t score = 0;
+		for (size_t j = 0; j + DMER_SIZE <= size; j++) {
+			uint32_t frequency = frequencies[dmerHash(start + j)];
+			if (frequency > 1)
+				score += frequency;
+		}
+		return score;
+	};
+	std::vector<Segment> segments;
+	sample = samples;
+	for (size_t i = 0; i < sampleSizes.size(); i++) {
+		for (size_t j = 0; j + DMER_SIZE <= sampleSizes[i]; j += SEGMENT_SIZE) {
+			size_t size = std::min(SEGMENT_SIZE, sampleSizes[i] - j);
+			uint64_t score = scoreSegment(sample + j, size);
+			if (score > 0)
+				segments.push_back({ sample + j, size, score });
 		}
+		sample += sampleSizes[i];
+	}
+	std::sort(segments.begin(), segments.end(), [](const Segment& a, const Segment& b) {
+		return a.score > b.score;
+	});
+	// greedily pick the best segments, rescoring each one so that d-mers already in the dictionary don't count again
+	std::vector<Segment*> picked;
+	size_t size = 0;
+	for (auto& segment : segments) {
+		if (size >= targetSize)
+			break;
+		if (scoreSegment(segment.start, segment.size) * 2 < segment.score)
+			continue; // mostly redundant with what has already been picked
+		for (size_t j = 0; j + DMER_SIZE <= segment.size; j++)
+			frequencies[dmerHash(segment.start + j)] = 0;
+		picked.push_back(&segment);
+		size += segment.size;
 	}
-	void OnOK() {
-		// don't actually call the callback, no need
+	// write the picked segments with the best ones last, dropping the start of the least valuable one if it doesn't fit
+	size_t position = std::min(size, targetSize);
+	size_t written = position;
+	for (Segment* segment : picked) {
+		size_t segmentSize = std::min(segment->size, position);
+		position -= segmentSize;
+		memcpy(target + position, segment->start + segment->size - segmentSize, segmentSize);
+		if (position == 0)
+			break;
 	}
+	return written;
+}
 
-  private:
+/*
+	Compression of values for asynchronous writes is done by a dedicated pool of compression threads (rather than
+	queuing a libuv work item for each value, competing with fs and crypto work). Compression slots are consumed from
+	a bounded queue in the order that they were written to the instruction buffer, which is the same order that the
+	write thread needs them in. If the queue is full, the slot is not queued, and the write thread compresses the value
+	itself when it gets to it, which applies backpressure without blocking the JS thread. A queued slot is claimed
+	while holding the queue lock, and the write thread cancels any queued slot that it compresses itself (also while
+	holding the lock), so that the compression threads never access an instruction after the write thread has moved
+	past it.
+*/
+typedef struct compression_slot_t {
 	EnvWrap* env;
 	double* compressionAddress;
-};
+} compression_slot_t;
+const unsigned int COMPRESSION_QUEUE_SIZE = 0x400;
+const unsigned int MAX_COMPRESSION_THREADS = 4;
+static pthread_mutex_t* compressionQueueLock;
+static pthread_cond_t* compressionQueueCond;
+static compression_slot_t compressionQueue[COMPRESSION_QUEUE_SIZE];
+// start and end positions in the ring buffer, these only increase and are used modulo the queue size
+static unsigned int compressionQueueStart;
+static unsigned int compressionQueueEnd;
+static std::atomic<bool> compressionPoolStarted(false);
+void compression_thread() {
+	while (true) {
+		pthread_mutex_lock(compressionQueueLock);
+		while (compressionQueueStart == compressionQueueEnd)
+			pthread_cond_wait(compressionQueueCond, compressionQueueLock);
+		compression_slot_t slot = compressionQueue[compressionQueueStart++ % COMPRESSION_QUEUE_SIZE];
+		int64_t compressionPointer = 0;
+		if (slot.compressionAddress) // claim it (if it wasn't cancelled)
+			compressionPointer = std::atomic_exchange((std::atomic<int64_t>*) slot.compressionAddress, (int64_t) 2);
+		pthread_mutex_unlock(compressionQueueLock);
+		if (compressionPointer > 2) {
+			Compression* compression = (Compression*)(size_t) * ((double*)&compressionPointer);
+			compression->compressInstruction(slot.env, slot.compressionAddress);
+		}
+	}
+}
+void startCompressionThreads() {
+	if (compressionPoolStarted.exchange(true))
+		return;
+	compressionQueueLock = new pthread_mutex_t;
+	pthread_mutex_init(compressionQueueLock, nullptr);
+	compressionQueueCond = new pthread_cond_t;
+	cond_init(compressionQueueCond);
+	// leave at least half the cores for the write thread, reads, and JS
+	unsigned int threads = std::thread::hardware_concurrency() / 2;
+	if (threads < 1)
+		threads = 1;
+	if (threads > MAX_COMPRESSION_THREADS)
+		threads = MAX_COMPRESSION_THREADS;
+	for (unsigned int i = 0; i < threads; i++)
+		std::thread(compression_thread).detach();
+}
+/*
+	Cancels the queued compression of the given slot, or of all the queued slots of the env if no slot is given. Slots
+	are queued in instruction order, so the first queued slot of the env is the only one the write thread can be at.
+*/
+void Compression::cancelCompression(EnvWrap* env, double* compressionAddress) {
+	if (!compressionPoolStarted)
+		return;
+	pthread_mutex_lock(compressionQueueLock);
+	for (unsigned int i = compressionQueueStart; i != compressionQueueEnd; i++) {
+		compression_slot_t& slot = compressionQueue[i % COMPRESSION_QUEUE_SIZE];
+		if (slot.env == env && slot.compressionAddress) {
+			if (compressionAddress) {
+				if (slot.compressionAddress == compressionAddress)
+					slot.compressionAddress = nullptr;
+				break;
+			}
+			slot.compressionAddress = nullptr;
+		}
+	}
+	pthread_mutex_unlock(compressionQueueLock);
+}
+
+/*
+	Compresses the next queued slot of the env (in the calling thread), returning false if there are none. This is used
+	by the write thread to help with upcoming compressions, while waiting for one that is in progress.
+*/
+bool Compression::compressQueued(EnvWrap* env) {
+	if (!compressionPoolStarted)
+		return false;
+	int64_t compressionPointer = 0;
+	double* compressionAddress = nullptr;
+	pthread_mutex_lock(compressionQueueLock);
+	for (unsigned int i = compressionQueueStart; i != compressionQueueEnd; i++) {
+		compression_slot_t& slot = compressionQueue[i % COMPRESSION_QUEUE_SIZE];
+		if (slot.env == env && slot.compressionAddress) {
+			compressionAddress = slot.compressionAddress;
+			slot.compressionAddress = nullptr; // taken
+			compressionPointer = std::atomic_exchange((std::atomic<int64_t>*) compressionAddress, (int64_t) 2);
+			break;
+		}
+	}
+	pthread_mutex_unlock(compressionQueueLock);
+	if (compressionPointer > 2) {
+		Compression* compression = (Compression*)(size_t) * ((double*)&compressionPointer);
+		compression->compressInstruction(nullptr, compressionAddress);
+	}
+	return compressionAddress;
+}
 
 NAPI_FUNCTION(EnvWrap::compress) {
-	ARGS(3)
-   GET_INT64_ARG(0);
-   EnvWrap* ew = (EnvWrap*) i64;
-   napi_get_value_int64(env, args[1], &i64);
-   double* compressionAddress = (double*) i64;
-	CompressionWorker* worker = new CompressionWorker(ew, (double*) compressionAddress, Function(env, args[2]));
-	worker->Queue();
-	RETURN_UNDEFINED;
+	ARGS(2)
+	GET_INT64_ARG(0);
+	EnvWrap* ew = (EnvWrap*) i64;
+	napi_get_value_int64(env, args[1], &i64);
+	double* compressionAddress = (double*) i64;
+	startCompressionThreads();
+	pthread_mutex_lock(compressionQueueLock);
+	bool queued = compressionQueueEnd - compressionQueueStart < COMPRESSION_QUEUE_SIZE;
+	if (queued) {
+		compressionQueue[compressionQueueEnd++ % COMPRESSION_QUEUE_SIZE] = { ew, compressionAddress };
+		pthread_cond_signal(compressionQueueCond);
+	} // else the queue is full, leave it for the write thread to compress
+	pthread_mutex_unlock(compressionQueueLock);
+	napi_get_boolean(env, queued, &returnValue);
+	return returnValue;
 }
 
 void Compression::setupExports(Napi::Env env, Object exports) {
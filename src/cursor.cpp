@@ -11,11 +11,13 @@ const int RENEW_CURSOR = 0x2000;
 const int EXACT_MATCH = 0x4000;
 const int INCLUSIVE_END = 0x8000;
 const int EXCLUSIVE_START = 0x10000;
+const int PENDING_START = 0x20000;
 
 CursorWrap::CursorWrap(const CallbackInfo& info) : Napi::ObjectWrap<CursorWrap>(info) {
 	this->keyType = LmdbKeyType::StringKey;
 	this->freeKey = nullptr;
 	this->endKey.mv_size = 0; // indicates no end key (yet)
+	this->hasPendingEntry = false;
 	if (info.Length() < 1) {
 		throwError(info.Env(), "Wrong number of arguments");
 		return;
@@ -76,14 +78,7 @@ Value CursorWrap::del(const CallbackInfo& info) {
 	}
 	return info.Env().Undefined();
 }
-int CursorWrap::returnEntry(int lastRC, MDB_val &key, MDB_val &data) {
-	if (lastRC) {
-		if (lastRC == MDB_NOTFOUND)
-			return 0;
-		else {
-			return lastRC > 0 ? -lastRC : lastRC;
-		}
-	}
+bool CursorWrap::isPastEnd(MDB_val &key, MDB_val &data) {
 	if (endKey.mv_size > 0) {
 		int comparison;
 		if (flags & VALUES_FOR_KEY)
@@ -92,9 +87,21 @@ int CursorWrap::returnEntry(int lastRC, MDB_val &key, MDB_val &data) {
 			comparison = mdb_cmp(txn, dw->dbi, &endKey, &key);
 		if ((flags & REVERSE) ? comparison >= 0 : (comparison <= 0)) {
 			if (!((flags & INCLUSIVE_END) && comparison == 0))
-				return 0;
+				return true;
+		}
+	}
+	return false;
+}
+int CursorWrap::returnEntry(int lastRC, MDB_val &key, MDB_val &data) {
+	if (lastRC) {
+		if (lastRC == MDB_NOTFOUND)
+			return 0;
+		else {
+			return lastRC > 0 ? -lastRC : lastRC;
 		}
 	}
+	if (isPastEnd(key, data))
+		return 0;
 	char* keyBuffer = dw->ew->keyBuffer;
 	if (flags & INCLUDE_VALUES) {
 		int result = getVersionAndUncompress(data, dw);
@@ -129,6 +136,7 @@ int32_t CursorWrap::doPosition(uint32_t offset, uint32_t keySize, uint64_t endKe
 	if (dw->ew->env == nullptr) {
 		return MDB_BAD_TXN;
 	}
+	hasPendingEntry = false;
 	if (flags & RENEW_CURSOR) { // TODO: check the txn_id to determine if we need to renew
 		rc = mdb_cursor_renew(txn = dw->ew->getReadTxn(), cursor);
 		if (rc) {
@@ -225,11 +233,36 @@ int32_t CursorWrap::doPosition(uint32_t offset, uint32_t keySize, uint64_t endKe
 		}
 	}
 
+#ifdef MDB_RPAGE_CACHE
+	// going forward through a db without duplicates, we can skip and count whole leaf pages at a time
+	bool pageable = !rc && !(flags & REVERSE) && !(dw->flags & MDB_DUPSORT);
+	if (pageable && offset > 0) {
+		mdb_size_t skipped;
+		rc = mdb_cursor_skip(cursor, offset, &skipped);
+		if (!rc)
+			rc = mdb_cursor_get(cursor, &key, &data, MDB_GET_CURRENT);
+		offset = 0;
+	}
+#endif
 	while (offset-- > 0 && !rc) {
 		rc = mdb_cursor_get(cursor, &key, &data, iteratingOp);
 	}
 	if (flags & ONLY_COUNT) {
 		uint32_t count = 0;
+#ifdef MDB_RPAGE_CACHE
+		if (pageable && !rc) {
+			mdb_size_t rangeCount;
+			rc = mdb_cursor_count_range(cursor, endKey.mv_size > 0 ? &endKey : nullptr, &rangeCount);
+			if (rc)
+				return rc > 0 ? -rc : rc;
+			count = rangeCount;
+			// the cursor is left on the first key at or after the end key
+			if ((flags & INCLUSIVE_END) && endKey.mv_size > 0 &&
+					!mdb_cursor_get(cursor, &key, &data, MDB_GET_CURRENT) && !mdb_cmp(txn, dw->dbi, &endKey, &key))
+				count++;
+			return count;
+		}
+#endif
 		bool useCursorCount = false;
 		// if we are in a dupsort database, and we are iterating over all entries, we can just count all the values for each key
 		if (dw->flags & MDB_DUPSORT) {
@@ -244,17 +277,8 @@ int32_t CursorWrap::doPosition(uint32_t offset, uint32_t keySize, uint64_t endKe
 		}
 
 		while (!rc) {
-			if (endKey.mv_size > 0) {
-				int comparison;
-				if (flags & VALUES_FOR_KEY)
-					comparison = mdb_dcmp(txn, dw->dbi, &endKey, &data);
-				else
-					comparison = mdb_cmp(txn, dw->dbi, &endKey, &key);
-				if ((flags & REVERSE) ? comparison >= 0 : (comparison <=0)) {
-					if (!((flags & INCLUSIVE_END) && comparison == 0))
-						return count;
-				}
-			}
+			if (isPastEnd(key, data))
+				return count;
 			if (useCursorCount) {
 				size_t countForKey;
 				rc = mdb_cursor_count(cursor, &countForKey);
@@ -270,6 +294,13 @@ int32_t CursorWrap::doPosition(uint32_t offset, uint32_t keySize, uint64_t endKe
 		}
 		return count;
 	}
+	if (flags & PENDING_START) {
+		// leave the first entry for the next batch, rather than returning it through the key buffer
+		if (rc || isPastEnd(key, data))
+			return returnEntry(rc, key, data);
+		hasPendingEntry = true;
+		return 1;
+	}
 	// TODO: Handle count?
 	return returnEntry(rc, key, data);
 }
@@ -295,6 +326,164 @@ int32_t positionFFI(double cwPointer, uint32_t flags, uint32_t offset, uint32_t
 	return cw->doPosition(offset, keySize, endKeyAddress);
 }
 
+const uint32_t AGGREGATE_HEADER_SIZE = 56;
+const uint32_t AGGREGATE_BIG_ENDIAN = 0x100;
+// reads the number of the given aggregate value type, returning false if it doesn't fit in the value
+static bool readAggregateValue(MDB_val &data, uint32_t valueOffset, uint32_t valueType, double &number) {
+	static const uint8_t widths[] = { 0, 1, 1, 2, 2, 4, 4, 4, 8, 8, 8 };
+	uint32_t type = valueType & 0xff;
+	if (type >= sizeof(widths))
+		return false;
+	uint32_t width = widths[type];
+	if ((size_t) valueOffset + width > data.mv_size)
+		return false;
+	char bytes[8];
+	char* source = (char*) data.mv_data + valueOffset;
+	if (valueType & AGGREGATE_BIG_ENDIAN) {
+		for (uint32_t i = 0; i < width; i++)
+			bytes[i] = source[width - i - 1];
+	} else
+		memcpy(bytes, source, width);
+	switch (type) {
+		case 1: number = *(int8_t*) bytes; break;
+		case 2: number = *(uint8_t*) bytes; break;
+		case 3: number = *(int16_t*) bytes; break;
+		case 4: number = *(uint16_t*) bytes; break;
+		case 5: number = *(int32_t*) bytes; break;
+		case 6: number = *(uint32_t*) bytes; break;
+		case 7: number = *(float*) bytes; break;
+		case 8: number = *(double*) bytes; break;
+		case 9: number = (double) *(int64_t*) bytes; break;
+		case 10: number = (double) *(uint64_t*) bytes; break;
+		default: return false;
+	}
+	return true;
+}
+/*
+	Aggregates the entries in the range inside the cursor loop, without returning any of the entries. The target
+	receives (as doubles) the entry count, the total key size, the total (stored) value size, and, if a value type is
+	given, the count, sum, min and max of the numbers at valueOffset in each value. These are followed by the first
+	and last keys of the range, each as a uint32 size and then the key.
+*/
+int32_t CursorWrap::doAggregate(uint32_t offset, uint32_t keySize, uint64_t endKeyAddress, char* target,
+		uint32_t targetSize, uint32_t valueOffset, uint32_t valueType) {
+	double* results = (double*) target;
+	double count = 0, keyBytes = 0, valueBytes = 0, numbers = 0, sum = 0, min = 0, max = 0;
+	uint32_t* firstKeySize = (uint32_t*) (target + AGGREGATE_HEADER_SIZE);
+	*firstKeySize = 0;
+	char* lastKeyTarget = (char*) (firstKeySize + 1);
+	flags |= PENDING_START;
+	int rc = doPosition(offset, keySize, endKeyAddress);
+	flags &= ~PENDING_START;
+	if (rc > 0) {
+		MDB_val key, data, lastKey;
+		hasPendingEntry = false;
+		rc = mdb_cursor_get(cursor, &key, &data, MDB_GET_CURRENT);
+		if (!rc && AGGREGATE_HEADER_SIZE + 8 + key.mv_size * 2 <= targetSize) {
+			*firstKeySize = key.mv_size;
+			memcpy(firstKeySize + 1, key.mv_data, key.mv_size);
+			lastKeyTarget += (key.mv_size + 3) & ~3;
+		}
+		*((uint32_t*) lastKeyTarget) = 0;
+		bool pastEnd = false;
+		while (!rc) {
+			if (isPastEnd(key, data)) {
+				pastEnd = true;
+				break;
+			}
+			count++;
+			keyBytes += key.mv_size;
+			if (dw->hasVersions) {
+				data.mv_data = (char*) data.mv_data + 8;
+				data.mv_size -= 8;
+			}
+			valueBytes += data.mv_size;
+			if (valueType) {
+				double number;
+				if (dw->compression) {
+					// the number may be in the compressed part of the value
+					if (dw->hasVersions) {
+						data.mv_data = (char*) data.mv_data - 8;
+						data.mv_size += 8;
+					}
+					if (!getVersionAndUncompress(data, dw))
+						data.mv_size = 0;
+				}
+				if (readAggregateValue(data, valueOffset, valueType, number)) {
+					if (numbers == 0 || number < min)
+						min = number;
+					if (numbers == 0 || number > max)
+						max = number;
+					numbers++;
+					sum += number;
+				}
+			}
+			lastKey = key;
+			rc = mdb_cursor_get(cursor, &key, &data, iteratingOp);
+		}
+		if (rc == MDB_NOTFOUND)
+			rc = 0;
+		if (!rc && count > 0) {
+#ifdef MDB_RPAGE_CACHE
+			unsigned int envFlags = 0;
+			mdb_env_get_flags(dw->ew->env, &envFlags);
+			if (envFlags & MDB_REMAP_CHUNKS) {
+				// the last key isn't necessarily still mapped, so move back to the last entry in the range to read it
+				MDB_cursor_op backOp;
+				switch (iteratingOp) {
+					case MDB_NEXT: backOp = MDB_PREV; break;
+					case MDB_PREV: backOp = MDB_NEXT; break;
+					case MDB_NEXT_DUP: backOp = MDB_PREV_DUP; break;
+					case MDB_PREV_DUP: backOp = MDB_NEXT_DUP; break;
+					case MDB_NEXT_NODUP: backOp = MDB_PREV_NODUP; break;
+					default: backOp = MDB_NEXT_NODUP;
+				}
+				// if the iteration ran off the end of the database, the cursor is still on the last entry
+				rc = mdb_cursor_get(cursor, &lastKey, &data, pastEnd ? backOp : MDB_GET_CURRENT);
+			}
+#endif
+			// the last key is left with a size of zero if it doesn't fit
+			if (!rc && (size_t) (lastKeyTarget - target) + 4 + lastKey.mv_size <= targetSize) {
+				*((uint32_t*) lastKeyTarget) = lastKey.mv_size;
+				memcpy(lastKeyTarget + 4, lastKey.mv_data, lastKey.mv_size);
+			}
+		}
+		if (rc == MDB_NOTFOUND)
+			rc = 0;
+		else if (rc > 0)
+			rc = -rc;
+	}
+	results[0] = count;
+	results[1] = keyBytes;
+	results[2] = valueBytes;
+	results[3] = numbers;
+	results[4] = sum;
+	results[5] = min;
+	results[6] = max;
+	return rc;
+}
+NAPI_FUNCTION(aggregate) {
+	ARGS(9)
+	GET_INT64_ARG(0);
+	CursorWrap* cw = (CursorWrap*) i64;
+	GET_UINT32_ARG(cw->flags, 1);
+	uint32_t offset;
+	GET_UINT32_ARG(offset, 2);
+	uint32_t keySize;
+	GET_UINT32_ARG(keySize, 3);
+	napi_get_value_int64(env, args[4], &i64);
+	int64_t endKeyAddress = i64;
+	napi_get_value_int64(env, args[5], &i64);
+	char* target = (char*) i64;
+	uint32_t targetSize;
+	GET_UINT32_ARG(targetSize, 6);
+	uint32_t valueOffset;
+	GET_UINT32_ARG(valueOffset, 7);
+	uint32_t valueType;
+	GET_UINT32_ARG(valueType, 8);
+	RETURN_INT32(cw->doAggregate(offset, keySize, endKeyAddress, target, targetSize, valueOffset, valueType));
+}
+
 NAPI_FUNCTION(iterate) {
 	ARGS(1)
     GET_INT64_ARG(0);
@@ -318,6 +507,97 @@ int32_t iterateFFI(double cwPointer) {
 	return cw->returnEntry(rc, key, data);
 }
 
+const uint32_t BATCH_VALUE_NOT_INCLUDED = 0xffffffff;
+/*
+	Iterates through up to maxEntries entries, packing them into the target buffer, so a range can be read with one
+	call per batch rather than one call per entry. Each entry is written as:
+	uint32 key size, uint32 value size (BATCH_VALUE_NOT_INCLUDED if the value needs to be retrieved with
+	getCurrentValue), the 8-byte version (if values are included and the db has versions), the key (null terminated)
+	and then the value, with the key and value each padded to 8 bytes.
+	Returns the number of entries written, and 0 when the iteration is done.
+	When offThread is set (reading from a read thread), the shared key buffer and decompression target are not
+	touched, the version is read directly from the entry and compressed values are left for the JS thread.
+*/
+int32_t CursorWrap::doIterateBatch(char* target, uint32_t targetSize, uint32_t maxEntries, bool offThread) {
+	if (dw->ew->env == nullptr)
+		return MDB_BAD_TXN;
+	MDB_val key, data;
+	bool includeValues = flags & INCLUDE_VALUES;
+	uint32_t headerSize = (includeValues && dw->hasVersions) ? 16 : 8;
+	uint32_t position = 0;
+	uint32_t count = 0;
+	while (count < maxEntries) {
+		int rc;
+		if (hasPendingEntry) {
+			// the entry that didn't fit in the last batch
+			rc = mdb_cursor_get(cursor, &key, &data, MDB_GET_CURRENT);
+			hasPendingEntry = false;
+		} else
+			rc = mdb_cursor_get(cursor, &key, &data, iteratingOp);
+		if (rc) {
+			if (rc == MDB_NOTFOUND)
+				break;
+			return rc > 0 ? -rc : rc;
+		}
+		if (isPastEnd(key, data))
+			break;
+		uint32_t valueSize = 0;
+		char* version = dw->ew->keyBuffer + 16;
+		if (includeValues) {
+			if (offThread) {
+				version = (char*) data.mv_data;
+				if (dw->hasVersions) {
+					data.mv_data = version + 8;
+					data.mv_size -= 8;
+				}
+				Compression* compression = dw->compression;
+				valueSize = (compression && compression->startingOffset < data.mv_size &&
+					((unsigned char*) data.mv_data)[compression->startingOffset] >= 250) ?
+					BATCH_VALUE_NOT_INCLUDED : data.mv_size;
+			} else
+				valueSize = getVersionAndUncompress(data, dw) ? data.mv_size : BATCH_VALUE_NOT_INCLUDED;
+		}
+		uint32_t valueOffset = position + headerSize + ((key.mv_size + 8) & ~7);
+		size_t end = valueOffset + (valueSize == BATCH_VALUE_NOT_INCLUDED ? 0 : valueSize);
+		if (end > targetSize) {
+			if (count > 0 || valueOffset > targetSize) {
+				// leave it for the next batch
+				hasPendingEntry = true;
+				break;
+			}
+			// the value will never fit, return just the key
+			valueSize = BATCH_VALUE_NOT_INCLUDED;
+			end = valueOffset;
+		}
+		uint32_t* header = (uint32_t*) (target + position);
+		header[0] = key.mv_size;
+		header[1] = valueSize;
+		if (headerSize > 8)
+			memcpy(header + 2, version, 8);
+		char* keyTarget = target + position + headerSize;
+		memcpy(keyTarget, key.mv_data, key.mv_size);
+		keyTarget[key.mv_size] = 0; // null terminated for the sake of better ordered-binary performance
+		if (valueSize != BATCH_VALUE_NOT_INCLUDED)
+			memcpy(target + valueOffset, data.mv_data, valueSize);
+		position = (end + 7) & ~7;
+		count++;
+		if (valueSize == BATCH_VALUE_NOT_INCLUDED)
+			break; // leave the cursor on this entry so the value can be retrieved
+	}
+	return count;
+}
+NAPI_FUNCTION(iterateBatch) {
+	ARGS(4)
+	GET_INT64_ARG(0);
+	CursorWrap* cw = (CursorWrap*) i64;
+	napi_get_value_int64(env, args[1], &i64);
+	char* target = (char*) i64;
+	uint32_t targetSize;
+	GET_UINT32_ARG(targetSize, 2);
+	uint32_t maxEntries;
+	GET_UINT32_ARG(maxEntries, 3);
+	RETURN_INT32(cw->doIterateBatch(target, targetSize, maxEntries));
+}
 
 NAPI_FUNCTION(getCurrentValue) {
 	ARGS(1)
@@ -362,6 +642,8 @@ void CursorWrap::setupExports(Napi::Env env, Object exports) {
 	});
 	EXPORT_NAPI_FUNCTION("position", position);
 	EXPORT_NAPI_FUNCTION("iterate", iterate);
+	EXPORT_NAPI_FUNCTION("iterateBatch", iterateBatch);
+	EXPORT_NAPI_FUNCTION("aggregate", aggregate);
 	EXPORT_NAPI_FUNCTION("getCurrentValue", getCurrentValue);
 	EXPORT_NAPI_FUNCTION("getCurrentShared", getCurrentShared);
 	EXPORT_NAPI_FUNCTION("renew", renew);
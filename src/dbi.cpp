@@ -180,6 +180,126 @@ int32_t DbiWrap::doGetByBinary(uint32_t keySize, uint32_t ifNotTxnId, int64_t tx
 #endif
 }
 
+// each result in a get-many target buffer starts with a 16 byte header: value size, status, and version (if used)
+const int GET_MANY_HEADER_SIZE = 16;
+const uint32_t GET_MANY_FOUND = 0;
+const uint32_t GET_MANY_NOT_FOUND = 1;
+const uint32_t GET_MANY_INDIVIDUALLY = 2; // couldn't be copied (too large or decompression failed), needs a standard get
+const uint32_t GET_MANY_SORTED = 1;
+// how far we will step forward from the current cursor position before just doing a search from the root
+const int GET_MANY_MAX_FORWARD_STEPS = 8;
+struct GetManyKey {
+	MDB_val key;
+	uint32_t index;
+};
+/*
+	Looks up a sequence of keys (in the same layout that prefetch uses) in one read txn with one cursor, and copies
+	all the values into the target buffer, each preceded by a header (with the size, status | index << 2, and version).
+	Returns the number of keys that were resolved, which may be less than the number of keys if the target buffer was
+	filled, so the caller can continue with the rest. With GET_MANY_SORTED, the keys are sorted first (with the db's
+	comparator), and then we walk forward from the last position when the next key is close, since that usually lands
+	on the same leaf page, and only search from the root when it is not.
+*/
+int32_t DbiWrap::doGetManyByBinary(uint32_t* keys, char* target, uint32_t targetSize, int64_t txnWrapAddress, uint32_t mode) {
+	MDB_txn* txn = ew->getReadTxn(txnWrapAddress);
+	std::vector<GetManyKey> entries;
+	uint32_t size;
+	while((size = *keys++) > 0) {
+		if (size == 0xffffffff) {
+			// it is a pointer to a new buffer
+			keys = (uint32_t*) (size_t) *((double*) keys); // read as a double pointer
+			size = *keys++;
+			if (size == 0)
+				break;
+		}
+		GetManyKey entry;
+		entry.key.mv_size = size;
+		entry.key.mv_data = (void*) keys;
+		entry.index = entries.size();
+		entries.push_back(entry);
+		keys += (size + 12) >> 2;
+	}
+	bool sorted = mode & GET_MANY_SORTED;
+	if (sorted) {
+		std::stable_sort(entries.begin(), entries.end(), [txn, this](const GetManyKey& a, const GetManyKey& b) {
+			return mdb_cmp(txn, dbi, &a.key, &b.key) < 0;
+		});
+	}
+	MDB_cursor *cursor;
+	int rc = mdb_cursor_open(txn, dbi, &cursor);
+	if (rc)
+		return rc > 0 ? -rc : rc;
+	MDB_cursor_op nextOp = (this->flags & MDB_DUPSORT) ? MDB_NEXT_NODUP : MDB_NEXT;
+	MDB_val current, currentData, data;
+	bool positioned = false; // the cursor is at current, which is the first key >= the last looked up key
+	bool exhausted = false; // the last looked up key was past the end of the db
+	uint32_t position = 0;
+	int32_t count = 0;
+	for (GetManyKey& entry : entries) {
+		if (position + GET_MANY_HEADER_SIZE > targetSize)
+			break;
+		uint32_t* header = (uint32_t*) (target + position);
+		bool found = false;
+		if (exhausted) {
+			// nothing left to find, remaining keys are after the end
+		} else if (sorted) {
+			int cmp = 1;
+			rc = 0;
+			if (positioned) {
+				cmp = mdb_cmp(txn, dbi, &entry.key, &current);
+				for (int steps = 0; cmp > 0 && steps < GET_MANY_MAX_FORWARD_STEPS; steps++) {
+					rc = mdb_cursor_get(cursor, &current, &currentData, nextOp);
+					if (rc)
+						break;
+					cmp = mdb_cmp(txn, dbi, &entry.key, &current);
+				}
+			}
+			if (!rc && cmp > 0) {
+				// not close, search from the root
+				current = entry.key;
+				rc = mdb_cursor_get(cursor, &current, &currentData, MDB_SET_RANGE);
+				if (!rc)
+					cmp = mdb_cmp(txn, dbi, &entry.key, &current);
+			}
+			if (rc == MDB_NOTFOUND)
+				exhausted = true;
+			positioned = !rc;
+			found = !rc && cmp == 0;
+		} else {
+			current = entry.key;
+			rc = mdb_cursor_get(cursor, &current, &currentData, MDB_SET_KEY);
+			found = !rc;
+		}
+		if (rc && rc != MDB_NOTFOUND) {
+			mdb_cursor_close(cursor);
+			return rc > 0 ? -rc : rc;
+		}
+		uint32_t status = GET_MANY_NOT_FOUND;
+		header[0] = 0;
+		if (found) {
+			data = currentData;
+			status = GET_MANY_INDIVIDUALLY;
+			// values that could never fit in the target are left for a standard get
+			if (getVersionAndUncompress(data, this) && GET_MANY_HEADER_SIZE + data.mv_size <= targetSize) {
+				size_t end = position + GET_MANY_HEADER_SIZE + data.mv_size;
+				if (end > targetSize)
+					break; // doesn't fit, the caller can continue with a new/bigger target
+				status = GET_MANY_FOUND;
+				header[0] = data.mv_size;
+				if (hasVersions)
+					memcpy(header + 2, ew->keyBuffer + 16, 8);
+				memcpy(target + position + GET_MANY_HEADER_SIZE, data.mv_data, data.mv_size);
+				position = ((end + 7) & ~7) - GET_MANY_HEADER_SIZE;
+			}
+		}
+		position += GET_MANY_HEADER_SIZE;
+		header[1] = status | (entry.index << 2);
+		count++;
+	}
+	mdb_cursor_close(cursor);
+	return count;
+}
+
 NAPI_FUNCTION(directWrite) {
 	ARGS(5)
 	GET_INT64_ARG(0);
@@ -227,6 +347,190 @@ uint32_t getByBinaryFFI(double dwPointer, uint32_t keySize, uint32_t ifNotTxnId,
 	return dw->doGetByBinary(keySize, ifNotTxnId, txnAddress);
 }
 
+NAPI_FUNCTION(getManyByBinary) {
+	ARGS(6)
+	GET_INT64_ARG(0);
+	DbiWrap* dw = (DbiWrap*) i64;
+	napi_get_value_int64(env, args[1], &i64);
+	uint32_t* keys = (uint32_t*) i64;
+	napi_get_value_int64(env, args[2], &i64);
+	char* target = (char*) i64;
+	uint32_t targetSize;
+	GET_UINT32_ARG(targetSize, 3);
+	int64_t txnAddress = 0;
+	napi_get_value_int64(env, args[4], &txnAddress);
+	uint32_t flags;
+	GET_UINT32_ARG(flags, 5);
+	RETURN_INT32(dw->doGetManyByBinary(keys, target, targetSize, txnAddress, flags));
+}
+
+/*
+	Finds up to parts - 1 keys that split the range between the start and end keys (each a uint32 size followed by
+	the key, with a size of zero meaning unbounded) into parts of similar size, by sampling the branch pages of the
+	database. The split keys are written to the target with the same layout, and the number of keys is returned.
+*/
+int32_t DbiWrap::doGetRangeSplits(int64_t txnWrapAddress, uint32_t parts, uint32_t* start, uint32_t* end, char* target, uint32_t targetSize) {
+#ifdef MDB_RPAGE_CACHE
+	MDB_txn* txn = ew->getReadTxn(txnWrapAddress);
+	MDB_val startKey, endKey;
+	startKey.mv_size = *start;
+	startKey.mv_data = start + 1;
+	endKey.mv_size = *end;
+	endKey.mv_data = end + 1;
+	if (parts < 2)
+		return 0;
+	std::vector<MDB_val> splits(parts - 1);
+	std::vector<char> keys(targetSize);
+	unsigned int count;
+	int rc = mdb_range_splits(txn, dbi, startKey.mv_size ? &startKey : nullptr, endKey.mv_size ? &endKey : nullptr,
+		parts, splits.data(), keys.data(), targetSize, &count);
+	if (rc)
+		return rc > 0 ? -rc : rc;
+	uint32_t position = 0;
+	for (unsigned int i = 0; i < count; i++) {
+		if (position + 4 + splits[i].mv_size > targetSize)
+			return i;
+		*((uint32_t*) (target + position)) = splits[i].mv_size;
+		memcpy(target + position + 4, splits[i].mv_data, splits[i].mv_size);
+		position = (position + splits[i].mv_size + 7) & ~3;
+	}
+	return count;
+#else
+	return 0; // the range can't be sampled with this version of LMDB, so it is left whole
+#endif
+}
+
+NAPI_FUNCTION(getRangeSplits) {
+	ARGS(7)
+	GET_INT64_ARG(0);
+	DbiWrap* dw = (DbiWrap*) i64;
+	int64_t txnAddress = 0;
+	napi_get_value_int64(env, args[1], &txnAddress);
+	uint32_t parts;
+	GET_UINT32_ARG(parts, 2);
+	napi_get_value_int64(env, args[3], &i64);
+	uint32_t* start = (uint32_t*) i64;
+	napi_get_value_int64(env, args[4], &i64);
+	uint32_t* end = (uint32_t*) i64;
+	napi_get_value_int64(env, args[5], &i64);
+	char* target = (char*) i64;
+	uint32_t targetSize;
+	GET_UINT32_ARG(targetSize, 6);
+	RETURN_INT32(dw->doGetRangeSplits(txnAddress, parts, start, end, target, targetSize));
+}
+
+/*
+	Gets a value and copies (or decompresses) it into the given target, up to the size of the target, so large values
+	can be read into a buffer sized for them, and just the beginning of a value can be read with a smaller target.
+	Returns the full size of the value.
+*/
+int32_t DbiWrap::doGetInto(uint32_t keySize, int64_t txnWrapAddress, char* target, uint32_t targetSize) {
+	MDB_txn* txn = ew->getReadTxn(txnWrapAddress);
+	MDB_val key, data;
+	key.mv_size = keySize;
+	key.mv_data = (void*) ew->keyBuffer;
+	int rc = mdb_get(txn, dbi, &key, &data);
+	if (rc)
+		return rc > 0 ? -rc : rc;
+	if (hasVersions) {
+		memcpy(ew->keyBuffer + 16, data.mv_data, 8);
+		data.mv_data = (char*) data.mv_data + 8;
+		data.mv_size -= 8;
+	}
+	size_t size = data.mv_size;
+	if (compression && compression->startingOffset < data.mv_size &&
+			((unsigned char*) data.mv_data)[compression->startingOffset] >= 250) {
+		if (compression->decompressInto(data, target, targetSize, size) < 0)
+			return MDB_CORRUPTED;
+	} else
+		memcpy(target, data.mv_data, std::min(size, (size_t) targetSize));
+	if (size < 0x80000000)
+		return size;
+	*((uint32_t*) ew->keyBuffer) = size;
+	return -30000;
+}
+
+NAPI_FUNCTION(getInto) {
+	ARGS(5)
+	GET_INT64_ARG(0);
+	DbiWrap* dw = (DbiWrap*) i64;
+	uint32_t keySize;
+	GET_UINT32_ARG(keySize, 1);
+	int64_t txnAddress = 0;
+	napi_get_value_int64(env, args[2], &txnAddress);
+	napi_get_value_int64(env, args[3], &i64);
+	char* target = (char*) i64;
+	uint32_t targetSize;
+	GET_UINT32_ARG(targetSize, 4);
+	RETURN_INT32(dw->doGetInto(keySize, txnAddress, target, targetSize));
+}
+
+int32_t DbiWrap::doTrainDictionary(int64_t txnWrapAddress, char* target, uint32_t targetSize, uint32_t sampleSize, int codec) {
+	MDB_txn* txn = ew->getReadTxn(txnWrapAddress);
+	MDB_stat stat;
+	int rc = mdb_stat(txn, dbi, &stat);
+	if (rc)
+		return rc > 0 ? -rc : rc;
+	if (stat.ms_entries == 0)
+		return 0;
+	// estimate the number of entries that will fill the sample size, so we can sample evenly across the database
+	size_t averageSize = (stat.ms_leaf_pages + stat.ms_overflow_pages) * (size_t) stat.ms_psize / stat.ms_entries + 1;
+	mdb_size_t stride = stat.ms_entries / (sampleSize / averageSize + 1);
+	if (stride < 1)
+		stride = 1;
+	MDB_cursor* cursor;
+	rc = mdb_cursor_open(txn, dbi, &cursor);
+	if (rc)
+		return rc > 0 ? -rc : rc;
+	std::vector<char> samples;
+	std::vector<size_t> sampleSizes;
+	samples.reserve(sampleSize);
+	MDB_val key, data;
+	rc = mdb_cursor_get(cursor, &key, &data, MDB_FIRST);
+	while (!rc && samples.size() < sampleSize) {
+		// decompress values that were already compressed (skipping any that don't fit in the decompression target)
+		if (getVersionAndUncompress(data, this) && data.mv_size > 0) {
+			size_t size = std::min(data.mv_size, sampleSize - samples.size());
+			samples.insert(samples.end(), (char*) data.mv_data, (char*) data.mv_data + size);
+			sampleSizes.push_back(size);
+		}
+#ifdef MDB_RPAGE_CACHE
+		if (!(flags & MDB_DUPSORT)) {
+			mdb_size_t skipped;
+			rc = mdb_cursor_skip(cursor, stride, &skipped);
+			if (!rc)
+				rc = mdb_cursor_get(cursor, &key, &data, MDB_GET_CURRENT);
+			continue;
+		}
+#endif
+		for (mdb_size_t i = 0; i < stride && !rc; i++)
+			rc = mdb_cursor_get(cursor, &key, &data, MDB_NEXT);
+	}
+	mdb_cursor_close(cursor);
+	if (rc && rc != MDB_NOTFOUND)
+		return rc > 0 ? -rc : rc;
+	if (sampleSizes.empty())
+		return 0;
+	return Compression::trainDictionary(samples.data(), sampleSizes, target, targetSize, (CompressionCodec) codec);
+}
+
+NAPI_FUNCTION(trainDictionary) {
+	ARGS(6)
+	GET_INT64_ARG(0);
+	DbiWrap* dw = (DbiWrap*) i64;
+	int64_t txnAddress = 0;
+	napi_get_value_int64(env, args[1], &txnAddress);
+	napi_get_value_int64(env, args[2], &i64);
+	char* target = (char*) i64;
+	uint32_t targetSize;
+	GET_UINT32_ARG(targetSize, 3);
+	uint32_t sampleSize;
+	GET_UINT32_ARG(sampleSize, 4);
+	int32_t codec;
+	GET_INT32_ARG(codec, 5);
+	RETURN_INT32(dw->doTrainDictionary(txnAddress, target, targetSize, sampleSize, codec));
+}
+
 napi_finalize noopDbi = [](napi_env, void *, void *) {
 	// Data belongs to LMDB, we shouldn't free it here
 };
@@ -384,6 +688,10 @@ void DbiWrap::setupExports(Napi::Env env, Object exports) {
 	exports.Set("Dbi", DbiClass);
 	EXPORT_NAPI_FUNCTION("directWrite", directWrite);
 	EXPORT_NAPI_FUNCTION("getByBinary", getByBinary);
+	EXPORT_NAPI_FUNCTION("getManyByBinary", getManyByBinary);
+	EXPORT_NAPI_FUNCTION("getRangeSplits", getRangeSplits);
+	EXPORT_NAPI_FUNCTION("trainDictionary", trainDictionary);
+	EXPORT_NAPI_FUNCTION("getInto", getInto);
 	EXPORT_NAPI_FUNCTION("prefetch", prefetchNapi);
 	EXPORT_NAPI_FUNCTION("getStringByBinary", getStringByBinary);
 	EXPORT_NAPI_FUNCTION("getSharedByBinary", getSharedByBinary);
@@ -328,6 +328,19 @@ Napi::Value EnvWrap::open(const CallbackInfo& info) {
 	//delete[] pathBytes;
 	if (rc != 0)
 		return throwLmdbError(info.Env(), rc);
+	// hold batch transactions open for more writes (up to this many ms) when under load
+	option = options.Get("commitLatencyBudget");
+	commitLatencyBudget = option.IsNumber() ? (uint64_t) (option.As<Number>().DoubleValue() * TICKS_PER_SECOND / 1000) : 0;
+#ifdef MDB_RPAGE_CACHE
+	// coalesce the overlapping syncs of this env with other envs in the process, waiting up to the given delay (in ms)
+	option = options.Get("groupSync");
+	if (option.IsNumber() || (option.IsBoolean() && option.As<Boolean>()))
+		mdb_env_set_group_sync(env, 1, option.IsNumber() ? (unsigned int) (option.As<Number>().DoubleValue() * 1000) : 1000);
+	// submit the page writes (and sync) of each commit through an io_uring of the given number of entries (Linux)
+	option = options.Get("ioUring");
+	if (option.IsNumber() || (option.IsBoolean() && option.As<Boolean>()))
+		mdb_env_set_io_uring(env, option.IsNumber() ? option.As<Number>().Uint32Value() : 256);
+#endif
 	if (!cleanupHookRegistered) {
 		napi_add_env_cleanup_hook(napiEnv, cleanup, this);
 		cleanupHookRegistered = true;
@@ -382,6 +395,13 @@ int EnvWrap::openEnv(int flags, int jsFlags, const char* path, char* keyBuffer,
 	#endif
 
 	timeTxnWaiting = 0;
+	timeCompressionWaiting = 0;
+	compressionStalls = 0;
+	writerCompressions = 0;
+	commitLatencyBudget = 0;
+	batchHoldTime = 0;
+	commitLatency = 0;
+	lastCommitEnd = 0;
 	// Set MDB_NOTLS to enable multiple read-only transactions on the same thread (in this case, the nodejs main thread)
 	flags |= MDB_NOTLS;
 	// TODO: make file attributes configurable
@@ -636,7 +656,7 @@ NAPI_FUNCTION(getTestRef) {
 	RETURN_UNDEFINED;
 }
 */
-int32_t EnvWrap::toSharedBuffer(MDB_env* env, uint32_t* keyBuffer,  MDB_val data) {
+int32_t EnvWrap::toSharedBuffer(MDB_env* env, uint32_t* keyBuffer,  MDB_val data, js_buffers_t* buffers) {
 	unsigned int flags;
 	mdb_env_get_flags(env, (unsigned int*) &flags);
 	#ifdef MDB_RPAGE_CACHE
@@ -675,20 +695,22 @@ int32_t EnvWrap::toSharedBuffer(MDB_env* env, uint32_t* keyBuffer,  MDB_val data
         end = bufferStart + 0xffffffffll;
     }
 	//fprintf(stderr, "mapAddress %p bufferStart %p", mapAddress, bufferStart);
-	pthread_mutex_lock(&sharedBuffers->modification_lock);
-	auto bufferSearch = sharedBuffers->buffers.find((char*)bufferStart);
+	if (!buffers) // the buffers of the current JS thread, other threads (like async reads) need to specify them
+		buffers = sharedBuffers;
+	pthread_mutex_lock(&buffers->modification_lock);
+	auto bufferSearch = buffers->buffers.find((char*)bufferStart);
 	size_t offset = dataAddress - bufferStart;
 	buffer_info_t bufferInfo;
-	if (bufferSearch == sharedBuffers->buffers.end()) {
+	if (bufferSearch == buffers->buffers.end()) {
         bufferInfo.end = (char*) end;
         bufferInfo.env = nullptr;
 		bufferInfo.isSharedMap = true;
-        bufferInfo.id = sharedBuffers->nextId++;
-        sharedBuffers->buffers.emplace((char*)bufferStart, bufferInfo);
+        bufferInfo.id = buffers->nextId++;
+        buffers->buffers.emplace((char*)bufferStart, bufferInfo);
 	} else {
 		bufferInfo = bufferSearch->second;
 	}
-	pthread_mutex_unlock(&sharedBuffers->modification_lock);
+	pthread_mutex_unlock(&buffers->modification_lock);
 	*keyBuffer = data.mv_size;
 	*(keyBuffer + 1) = bufferInfo.id;
 	*(keyBuffer + 2) = offset;
@@ -700,6 +722,8 @@ void notifyCallbacks(std::vector<napi_threadsafe_function> callbacks, bool relea
 void EnvWrap::closeEnv(bool hasLock) {
 	if (!env)
 		return;
+	// don't let the compression threads access instructions of this env once it is closed
+	Compression::cancelCompression(this, nullptr);
 #ifdef MDB_OVERLAPPINGSYNC
 	// unlock any record locks held by this thread/EnvWrap
 	ExtendedEnv* extended_env = (ExtendedEnv*) mdb_env_get_userctx(env);
@@ -859,6 +883,12 @@ Napi::Value EnvWrap::info(const CallbackInfo& info) {
 	stats.Set("lastTxnId", Number::New(info.Env(), envinfo.me_last_txnid));
 	stats.Set("maxReaders", Number::New(info.Env(), envinfo.me_maxreaders));
 	stats.Set("numReaders", Number::New(info.Env(), envinfo.me_numreaders));
+	stats.Set("compressionStalls", Number::New(info.Env(), (double) compressionStalls));
+	stats.Set("writerCompressions", Number::New(info.Env(), (double) writerCompressions));
+	if (commitLatencyBudget) {
+		stats.Set("batchHoldTime", Number::New(info.Env(), (double) batchHoldTime / TICKS_PER_SECOND));
+		stats.Set("commitLatency", Number::New(info.Env(), (double) commitLatency / TICKS_PER_SECOND));
+	}
 	#ifdef MDB_OVERLAPPINGSYNC
 	unsigned int envFlags;
 	mdb_env_get_flags(env, &envFlags);
@@ -869,6 +899,7 @@ Napi::Value EnvWrap::info(const CallbackInfo& info) {
 		stats.Set("timePageFlushes", Number::New(info.Env(), (double) metrics->time_page_flushes / TICKS_PER_SECOND));
 		stats.Set("timeSync", Number::New(info.Env(), (double) metrics->time_sync / TICKS_PER_SECOND));
 		stats.Set("timeTxnWaiting", Number::New(info.Env(), (double) timeTxnWaiting / TICKS_PER_SECOND));
+		stats.Set("timeCompressionWaiting", Number::New(info.Env(), (double) timeCompressionWaiting / TICKS_PER_SECOND));
 		stats.Set("txns", Number::New(info.Env(), metrics->txns));
 		stats.Set("pageFlushes", Number::New(info.Env(), metrics->page_flushes));
 		stats.Set("pagesWritten", Number::New(info.Env(), metrics->pages_written));
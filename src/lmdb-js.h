@@ -72,6 +72,7 @@ typedef size_t mdb_size_t;
 
 #ifdef _WIN32
 const uint64_t TICKS_PER_SECOND = 1000;
+const uint64_t TICKS_PER_TIMED_WAIT = 1; // cond_timedwait waits in milliseconds
 int pthread_mutex_init(pthread_mutex_t *mutex, pthread_mutexattr_t *attr);
 int pthread_mutex_destroy(pthread_mutex_t *mutex);
 int pthread_mutex_lock(pthread_mutex_t *mutex);
@@ -83,6 +84,7 @@ int pthread_cond_signal(pthread_cond_t *cond);
 int pthread_cond_broadcast(pthread_cond_t *cond);
 #else
 const uint64_t TICKS_PER_SECOND = 1000000000;
+const uint64_t TICKS_PER_TIMED_WAIT = 10000; // cond_timedwait waits in 10 microsecond units
 #endif
 uint64_t get_time64();
 uint64_t next_time_double();
@@ -162,6 +164,7 @@ napi_value getAddress(napi_env env, napi_callback_info info);
 napi_value detachBuffer(napi_env env, napi_callback_info info);
 napi_value enableThreadSafeCalls(napi_env env, napi_callback_info info);
 napi_value startRead(napi_env env, napi_callback_info info);
+napi_value startIterateBatch(napi_env env, napi_callback_info info);
 napi_value setReadCallback(napi_env env, napi_callback_info info);
 Value getAddress(const CallbackInfo& info);
 Value lmdbNativeFunctions(const CallbackInfo& info);
@@ -225,6 +228,7 @@ class WriteWorker {
 	MDB_txn* AcquireTxn(int* flags);
 	void UnlockTxn();
 	int WaitForCallbacks(MDB_txn** txn, bool allowCommit, uint32_t* target);
+	bool HoldBatch(uint32_t* target);
 	virtual void SendUpdate();
 	int interruptionStatus;
 	bool finishedProgress;
@@ -238,6 +242,7 @@ class WriteWorker {
 	uint32_t* instructions;
 	int progressStatus;
 	MDB_env* env;
+	uint64_t txnStartTime;
 	static int DoWrites(MDB_txn* txn, EnvWrap* envForTxn, uint32_t* instruction, WriteWorker* worker);
 	static bool threadSafeCallsEnabled;
 };
@@ -351,6 +356,13 @@ public:
 	bool readTxnRenewed;
     bool hasWrites;
 	uint64_t timeTxnWaiting;
+	uint64_t timeCompressionWaiting; // time the write thread spent waiting on compression threads
+	uint64_t compressionStalls; // number of times the write thread waited on compression threads
+	uint64_t writerCompressions; // number of values the write thread compressed itself
+	uint64_t commitLatencyBudget; // how long (in ticks) a batch transaction can be held open for more writes, 0 to never hold
+	uint64_t batchHoldTime; // how long the write thread currently waits for more writes before committing, adapted to the load
+	uint64_t commitLatency; // moving average of the time to commit a batch
+	uint64_t lastCommitEnd;
 	unsigned int jsFlags;
 	char* keyBuffer;
 	int pageSize;
@@ -461,7 +473,7 @@ public:
 	static napi_value compress(napi_env env, napi_callback_info info);
 	static napi_value write(napi_env env, napi_callback_info info);
 	static napi_value onExit(napi_env env, napi_callback_info info);
-	static int32_t toSharedBuffer(MDB_env* env, uint32_t* keyBuffer, MDB_val data);
+	static int32_t toSharedBuffer(MDB_env* env, uint32_t* keyBuffer, MDB_val data, js_buffers_t* buffers = nullptr);
 };
 
 const int TXN_ABORTABLE = 1;
@@ -586,24 +598,50 @@ public:
 	int prefetch(uint32_t* keys);
 	int open(int flags, char* name, bool hasVersions, LmdbKeyType keyType, Compression* compression);
 	int32_t doGetByBinary(uint32_t keySize, uint32_t ifNotTxnId, int64_t txnAddress);
+	int32_t doGetManyByBinary(uint32_t* keys, char* target, uint32_t targetSize, int64_t txnAddress, uint32_t mode);
+	int32_t doGetRangeSplits(int64_t txnAddress, uint32_t parts, uint32_t* start, uint32_t* end, char* target, uint32_t targetSize);
+	int32_t doGetInto(uint32_t keySize, int64_t txnAddress, char* target, uint32_t targetSize);
+	int32_t doTrainDictionary(int64_t txnAddress, char* target, uint32_t targetSize, uint32_t sampleSize, int codec);
 	static void setupExports(Napi::Env env, Object exports);
 };
 
+enum class CompressionCodec {
+	LZ4 = 0,
+	LZ4HC = 1, // higher compression ratio, slower compression, the same (LZ4) decompression
+	ZSTD = 2 // only available when built with zstd (LMDB_ZSTD=true)
+};
 class Compression : public ObjectWrap<Compression> {
 public:
 	char* dictionary; // dictionary to use to decompress
 	char* compressDictionary; // separate dictionary to use to compress since the decompression dictionary can move around in the main thread
 	unsigned int dictionarySize;
+	unsigned int compressDictionarySize;
+	// versioned dictionaries, the dictionary at index i has id i + 1 (id 0 is the base dictionary)
+	std::vector<MDB_val> dictionaries;
+	uint8_t dictionaryId; // id of the dictionary used to compress
 	char* decompressTarget;
 	unsigned int decompressSize;
 	unsigned int compressionThreshold;
 	unsigned int startingOffset; // compression can be configured to start compression at a certain offset, so header bytes are left uncompressed.
 	// compression acceleration (defaults to 1)
 	int acceleration;
+	CompressionCodec codec; // used to compress, any codec can be decompressed
+	int level; // compression level for LZ4HC and zstd (0 for the codec's default)
 	static thread_local LZ4_stream_t* stream;
+	int readHeader(unsigned char* charData, uint32_t& uncompressedLength, char*& decompressDictionary, size_t& decompressDictionarySize);
 	void decompress(MDB_val& data, bool &isValid, bool canAllocate);
+	int64_t decompressInto(MDB_val& data, char* target, size_t targetSize, size_t& fullSize);
 	argtokey_callback_t compress(MDB_val* value, argtokey_callback_t freeValue);
+	size_t compressedBound(size_t size);
+	size_t compressInto(char* data, size_t size, char* target, size_t targetSize);
 	int compressInstruction(EnvWrap* env, double* compressionAddress);
+	// compressed values are allocated from per-thread arenas, and released (from any thread) once they are written
+	static char* allocateCompressed(size_t size);
+	static void trimCompressed(char* data, size_t size);
+	static void releaseCompressed(void* data);
+	static void cancelCompression(EnvWrap* env, double* compressionAddress);
+	static bool compressQueued(EnvWrap* env);
+	static size_t trainDictionary(const char* samples, const std::vector<size_t>& sampleSizes, char* target, size_t targetSize, CompressionCodec codec);
 	Napi::Value ctor(const CallbackInfo& info);
 	Napi::Value setBuffer(const CallbackInfo& info);
 	Compression(const CallbackInfo& info);
@@ -635,6 +673,8 @@ public:
 	int flags;
 	DbiWrap *dw;
 	MDB_txn *txn;
+	// the cursor is on an entry that didn't fit in the last batch
+	bool hasPendingEntry;
 
 	// The wrapped object
 	CursorWrap(MDB_cursor* cursor);
@@ -661,7 +701,11 @@ public:
 	Napi::Value del(const CallbackInfo& info);
 
 	int returnEntry(int lastRC, MDB_val &key, MDB_val &data);
+	bool isPastEnd(MDB_val &key, MDB_val &data);
 	int32_t doPosition(uint32_t offset, uint32_t keySize, uint64_t endKeyAddress);
+	int32_t doIterateBatch(char* target, uint32_t targetSize, uint32_t maxEntries, bool offThread = false);
+	int32_t doAggregate(uint32_t offset, uint32_t keySize, uint64_t endKeyAddress, char* target, uint32_t targetSize,
+		uint32_t valueOffset, uint32_t valueType);
 	//Value getStringByBinary(const CallbackInfo& info);
 };
 
@@ -1,5 +1,6 @@
 #include "lmdb-js.h"
 #include <atomic>
+#include <thread>
 #include <string.h>
 #include <stdio.h>
 #include <node_version.h>
@@ -32,6 +33,7 @@ void setupExportMisc(Napi::Env env, Object exports) {
 	EXPORT_NAPI_FUNCTION("getBufferAddress", getBufferAddress);
 	EXPORT_NAPI_FUNCTION("detachBuffer", detachBuffer);
 	EXPORT_NAPI_FUNCTION("startRead", startRead);
+	EXPORT_NAPI_FUNCTION("startIterateBatch", startIterateBatch);
 	EXPORT_NAPI_FUNCTION("setReadCallback", setReadCallback);
 	EXPORT_NAPI_FUNCTION("enableThreadSafeCalls", enableThreadSafeCalls);
 	napi_value globalBuffer;
@@ -245,47 +247,81 @@ typedef struct { // this is read results data buffer that is actively being used
 	char* data;
 	uint32_t offset;
 	uint32_t size;
+	// number of results in this buffer whose completion callbacks haven't finished yet, once this is zero
+	// the buffer can be reused
+	std::atomic<uint32_t> outstanding;
 } read_results_buffer_t;
+/*
+	The read results buffers that a read thread writes to for a given JS thread. These are only used for envs with
+	remapped chunks, where values can't be referenced in the memory map (all other values are returned as map offsets,
+	and not found results have nothing to copy). Buffers are reused once all of their results have been delivered, so
+	memory is bounded by the number of results in flight, rather than growing until the buffers are collected.
+*/
+typedef struct {
+	std::vector<read_results_buffer_t*> buffers;
+	read_results_buffer_t* current;
+} read_results_arena_t;
+const uint32_t READ_RESULTS_BUFFER_SIZE = 0x40000; // 256KB
 
-static thread_local std::unordered_map<void*, read_results_buffer_t*>* buffersByWorker;
+static thread_local std::unordered_map<void*, read_results_arena_t*>* arenasByWorker;
 
-typedef struct {
-	napi_ref callback;
-	napi_ref resource;
-} read_callback_t;
 static int next_buffer_id = -1;
-typedef struct {
+struct read_instruction_t;
+typedef struct { // there is one instance of this for each JS thread that is doing async reads
+	napi_threadsafe_function callback;
+	// completed reads, pushed by the read threads, and drained as a batch by the JS thread
+	std::atomic<read_instruction_t*> completed;
+	uint32_t* completedIds; // shared buffer that the callback ids of a drained batch are written to
+	uint32_t completedIdsSize;
+	napi_ref completedIdsReference;
+	uint32_t outstanding; // only accessed from the JS thread
+} read_completions_t;
+static thread_local read_completions_t* readCompletions;
+typedef struct read_instruction_t {
 	uint32_t* instructionAddress;
 	uint32_t callback_id;
-	napi_async_work work;
-	//napi_deferred deferred;
 	js_buffers_t* buffers;
+	read_completions_t* completions;
+	read_results_buffer_t* resultsBuffer; // the buffer the result was copied to, if any
+	// for iterating a batch of entries from a positioned cursor, rather than a get (the instruction address is then
+	// the batch buffer)
+	CursorWrap* cursor;
+	uint32_t batchSize;
+	uint32_t maxEntries;
+	read_instruction_t* next;
 } read_instruction_t;
+/*
+	Async reads are executed by a dedicated pool of read threads (rather than queuing a libuv work item for each read).
+	Reads are submitted to a shared queue, and each read thread takes a batch of reads at a time, reusing a cursor for
+	consecutive reads of the same txn and dbi. The cursors are all closed before the completions are posted back to JS,
+	since the txn is only guaranteed to be alive until the completion callback runs.
+*/
+const int READ_BATCH_SIZE = 8;
+const unsigned int MAX_READ_THREADS = 8;
+static pthread_mutex_t* readQueueLock;
+static pthread_cond_t* readQueueCond;
+static read_instruction_t* readQueueHead;
+static read_instruction_t* readQueueTail;
+static std::atomic<bool> readPoolStarted(false);
 const uint32_t ZERO = 0;
-void do_read(napi_env nenv, void* instruction_pointer) {
-	read_instruction_t* readInstruction = (read_instruction_t*) instruction_pointer;
+void do_read(read_instruction_t* readInstruction, MDB_cursor* cursor) {
 	//fprintf(stderr, "lock %p\n", &readInstruction->buffers->modification_lock);
 	uint32_t* instruction = readInstruction->instructionAddress;
 	MDB_val key;
 	key.mv_size = *(instruction + 3);
-	MDB_dbi dbi = (MDB_dbi) (*(instruction + 2) & 0xffff) ;
 	MDB_val data;
-	TxnWrap* tw = (TxnWrap*) (size_t) *((double*)instruction);
-	MDB_txn* txn = tw->txn;
-	mdb_txn_renew(txn);
+	MDB_txn* txn = mdb_cursor_txn(cursor);
 	unsigned int flags;
-	mdb_dbi_flags(txn, dbi, &flags);
+	mdb_dbi_flags(txn, mdb_cursor_dbi(cursor), &flags);
 	bool dupSort = flags & MDB_DUPSORT;
 	int effected = 0;
-	MDB_cursor *cursor;
 	MDB_env* env = mdb_txn_env(txn);
-	int rc = mdb_cursor_open(txn, dbi, &cursor);
+	key.mv_data = (void*) (instruction + 4);
+	int rc = mdb_cursor_get(cursor, &key, &data, MDB_SET_KEY);
 	if (rc) {
-		*instruction = rc;
-		return;
+		data.mv_size = 0;
+		data.mv_data = nullptr;
 	}
-	key.mv_data = (void*) (instruction + 4);
-	rc = mdb_cursor_get(cursor, &key, &data, MDB_SET_KEY);
 	*(instruction + 3) = data.mv_size;
 
 	//instruction += (key.mv_size + 28) >> 2;
@@ -303,42 +339,59 @@ void do_read(napi_env nenv, void* instruction_pointer) {
 			rc = 1; // done
 
 	}
-	*instruction = rc;
 	unsigned int env_flags = 0;
 	mdb_env_get_flags(env, &env_flags);
-	if (data.mv_size > 4096
+	// Values of any size are returned as an offset into the (shared) memory map, so they can be decoded without a
+	// copy. The JS side holds the read txn (pinning the snapshot) until its completion callback has run.
+	if (data.mv_data)
+		rc = 1; // found, even if a dupsort read ended with MDB_NOTFOUND from the last MDB_NEXT_DUP
+	if (!data.mv_data) {
+		*instruction = rc; // not found, there is no result to copy
 #ifdef MDB_RPAGE_CACHE
-	 && !(env_flags & MDB_REMAP_CHUNKS)
-#endif
-	 ) {
-		EnvWrap::toSharedBuffer(env, instruction, data);
-		*((double*)instruction) = (double) (size_t) data.mv_data;
-	} else {
-		if (!buffersByWorker)
-			buffersByWorker = new std::unordered_map<void*, read_results_buffer_t*>;
-		read_results_buffer_t* read_buffer;
-		auto buffer_search = buffersByWorker->find(readInstruction->buffers);
-		if (buffer_search == buffersByWorker->end()) {
+	} else if (env_flags & MDB_REMAP_CHUNKS) {
+		// remapped chunks may be unmapped once the txn ends, so the value is copied to a results buffer
+		*instruction = rc;
+		if (!arenasByWorker)
+			arenasByWorker = new std::unordered_map<void*, read_results_arena_t*>;
+		read_results_arena_t* arena;
+		auto arena_search = arenasByWorker->find(readInstruction->buffers);
+		if (arena_search == arenasByWorker->end()) {
 			// create new one
-			buffersByWorker->emplace(readInstruction->buffers, read_buffer = new read_results_buffer_t);
-			read_buffer->size = 0;
-			read_buffer->offset = 0; // force it re-malloc
+			arenasByWorker->emplace(readInstruction->buffers, arena = new read_results_arena_t);
+			arena->current = nullptr;
 		} else
-			read_buffer = buffer_search->second;
-		if ((int) read_buffer->size - (int) read_buffer->offset - 4 < (int) data.mv_size) {
-			size_t size = 0x40000;// 256KB
-			read_buffer->data = (char*) malloc(size);
-			read_buffer->size = size;
-			read_buffer->offset = 0;
-			buffer_info_t buffer_info;
-			buffer_info.end = read_buffer->data + size;
-			buffer_info.env = nullptr;
-			buffer_info.isSharedMap = false;
-			pthread_mutex_lock(&readInstruction->buffers->modification_lock);
-			buffer_info.id = read_buffer->id = readInstruction->buffers->nextId++;
-			readInstruction->buffers->buffers.emplace(read_buffer->data, buffer_info);
-			pthread_mutex_unlock(&readInstruction->buffers->modification_lock);
-
+			arena = arena_search->second;
+		read_results_buffer_t* read_buffer = arena->current;
+		if (!read_buffer || (int) read_buffer->size - (int) read_buffer->offset - 4 < (int) data.mv_size) {
+			// find a buffer that has been completely delivered, and reuse it
+			read_buffer = nullptr;
+			for (read_results_buffer_t* buffer : arena->buffers) {
+				if (buffer->outstanding.load(std::memory_order_acquire) == 0 && buffer->size - 4 >= data.mv_size) {
+					read_buffer = buffer;
+					read_buffer->offset = 0;
+					break;
+				}
+			}
+			if (!read_buffer) {
+				read_buffer = new read_results_buffer_t;
+				size_t size = READ_RESULTS_BUFFER_SIZE;
+				if (data.mv_size + 8 > size)
+					size = (data.mv_size + 0xfff) & ~0xfff;
+				read_buffer->data = (char*) malloc(size);
+				read_buffer->size = size;
+				read_buffer->offset = 0;
+				read_buffer->outstanding = 0;
+				buffer_info_t buffer_info;
+				buffer_info.end = read_buffer->data + size;
+				buffer_info.env = nullptr;
+				buffer_info.isSharedMap = false;
+				pthread_mutex_lock(&readInstruction->buffers->modification_lock);
+				buffer_info.id = read_buffer->id = readInstruction->buffers->nextId++;
+				readInstruction->buffers->buffers.emplace(read_buffer->data, buffer_info);
+				pthread_mutex_unlock(&readInstruction->buffers->modification_lock);
+				arena->buffers.push_back(read_buffer);
+			}
+			arena->current = read_buffer;
 		}
 		auto position = (uint32_t*) (read_buffer->data + read_buffer->offset);
 		memcpy(position, data.mv_data, data.mv_size);
@@ -346,23 +399,136 @@ void do_read(napi_env nenv, void* instruction_pointer) {
 		*(instruction + 1) = read_buffer->id;
 		*(instruction + 2) = read_buffer->offset;
 		read_buffer->offset = (char*)position - read_buffer->data;
+		read_buffer->outstanding++;
+		readInstruction->resultsBuffer = read_buffer;
+#endif
+	} else {
+		EnvWrap::toSharedBuffer(env, instruction, data, readInstruction->buffers);
+		*instruction = rc;
 	}
-	mdb_cursor_close(cursor);
 	//fprintf(stderr, "unlock %p\n", &readInstruction->buffers->modification_lock);
 }
-static thread_local napi_ref* read_callback;
-void read_complete(napi_env env, napi_status status, void* data) {
-	read_instruction_t* readInstruction = (read_instruction_t*) data;
-	napi_value callback;
-	napi_get_reference_value(env, *read_callback, &callback);
-	//uint32_t count;
-	napi_value result;
-	napi_value callback_id;
-	napi_create_int32(env, readInstruction->callback_id, &callback_id);
-	status = napi_call_function(env, callback, callback, 1, &callback_id, &result);
-	napi_delete_async_work(env, readInstruction->work);
-	delete readInstruction;
-	//napi_resolve_deferred(env, readInstruction->deferred, resolution);
+void read_batch(read_instruction_t* batch) {
+	MDB_cursor* cursor = nullptr;
+	MDB_txn* cursorTxn = nullptr;
+	MDB_dbi cursorDbi = 0;
+	for (read_instruction_t* readInstruction = batch; readInstruction; readInstruction = readInstruction->next) {
+		uint32_t* instruction = readInstruction->instructionAddress;
+		if (readInstruction->cursor) {
+			// the result (entry count) goes in the first word, followed by the entries
+			*((int32_t*) instruction) = readInstruction->cursor->doIterateBatch((char*) (instruction + 2),
+				readInstruction->batchSize - 8, readInstruction->maxEntries, true);
+			continue;
+		}
+		MDB_dbi dbi = (MDB_dbi) (*(instruction + 2) & 0xffff);
+		TxnWrap* tw = (TxnWrap*) (size_t) *((double*)instruction);
+		MDB_txn* txn = tw->txn;
+		if (!cursor || txn != cursorTxn || dbi != cursorDbi) {
+			if (cursor)
+				mdb_cursor_close(cursor);
+			cursor = nullptr;
+			mdb_txn_renew(txn);
+			int rc = mdb_cursor_open(txn, dbi, &cursor);
+			if (rc) {
+				cursor = nullptr;
+				*instruction = rc;
+				continue;
+			}
+			cursorTxn = txn;
+			cursorDbi = dbi;
+		}
+		do_read(readInstruction, cursor);
+	}
+	if (cursor)
+		mdb_cursor_close(cursor);
+	for (read_instruction_t* readInstruction = batch; readInstruction;) {
+		read_instruction_t* next = readInstruction->next;
+		read_completions_t* completions = readInstruction->completions;
+		readInstruction->next = completions->completed.load(std::memory_order_relaxed);
+		while (!completions->completed.compare_exchange_weak(readInstruction->next, readInstruction,
+				std::memory_order_release, std::memory_order_relaxed)) {}
+		// only the first completion needs to wake up the JS thread, it will drain the rest of them
+		if (!readInstruction->next)
+			napi_call_threadsafe_function(completions->callback, nullptr, napi_tsfn_blocking);
+		readInstruction = next;
+	}
+}
+void read_thread() {
+	while (true) {
+		pthread_mutex_lock(readQueueLock);
+		while (!readQueueHead)
+			pthread_cond_wait(readQueueCond, readQueueLock);
+		// take a batch of reads off the front of the queue, leaving the rest for the other read threads
+		read_instruction_t* batch = readQueueHead;
+		read_instruction_t* last = batch;
+		for (int i = 1; i < READ_BATCH_SIZE && last->next; i++)
+			last = last->next;
+		readQueueHead = last->next;
+		if (!readQueueHead)
+			readQueueTail = nullptr;
+		last->next = nullptr;
+		pthread_mutex_unlock(readQueueLock);
+		read_batch(batch);
+	}
+}
+void startReadThreads() {
+	if (readPoolStarted.exchange(true))
+		return;
+	readQueueLock = new pthread_mutex_t;
+	pthread_mutex_init(readQueueLock, nullptr);
+	readQueueCond = new pthread_cond_t;
+	cond_init(readQueueCond);
+	unsigned int threads = std::thread::hardware_concurrency();
+	if (threads < 2)
+		threads = 2;
+	if (threads > MAX_READ_THREADS)
+		threads = MAX_READ_THREADS;
+	for (unsigned int i = 0; i < threads; i++)
+		std::thread(read_thread).detach();
+}
+/*
+	Drains all the completed reads for this JS thread, writing the callback ids into the shared completed ids buffer
+	and calling the JS read callback once per (buffer-full) batch with the number of completed reads.
+*/
+void read_complete(napi_env env, napi_value callback, void* context, void* data) {
+	read_completions_t* completions = (read_completions_t*) context;
+	read_instruction_t* readInstruction = completions->completed.exchange(nullptr, std::memory_order_acquire);
+	// the list was pushed as a stack, reverse it so callbacks are in completion order
+	read_instruction_t* ordered = nullptr;
+	while (readInstruction) {
+		read_instruction_t* next = readInstruction->next;
+		readInstruction->next = ordered;
+		ordered = readInstruction;
+		readInstruction = next;
+	}
+	while (ordered) {
+		uint32_t count = 0;
+		read_instruction_t* batch = ordered;
+		read_instruction_t* last = nullptr;
+		while (ordered && count < completions->completedIdsSize) {
+			completions->completedIds[count++] = ordered->callback_id;
+			last = ordered;
+			ordered = ordered->next;
+		}
+		last->next = nullptr;
+		if (env) {
+			completions->outstanding -= count;
+			if (completions->outstanding == 0)
+				napi_unref_threadsafe_function(env, completions->callback);
+			napi_value result;
+			napi_value count_value;
+			napi_create_uint32(env, count, &count_value);
+			napi_call_function(env, callback, callback, 1, &count_value, &result);
+		}
+		// the callbacks are done with the results now, so their buffers can be reused
+		while (batch) {
+			read_instruction_t* next = batch->next;
+			if (batch->resultsBuffer)
+				batch->resultsBuffer->outstanding.fetch_sub(1, std::memory_order_release);
+			delete batch;
+			batch = next;
+		}
+	}
 }
 NAPI_FUNCTION(enableThreadSafeCalls) {
 	WriteWorker::threadSafeCallsEnabled = true;
@@ -371,25 +537,78 @@ NAPI_FUNCTION(enableThreadSafeCalls) {
 }
 
 NAPI_FUNCTION(setReadCallback) {
-	ARGS(1)
-	read_callback = new napi_ref;
-	napi_create_reference(env, args[0], 1, read_callback);
+	ARGS(2)
+	readCompletions = new read_completions_t;
+	readCompletions->outstanding = 0;
+	readCompletions->completed = nullptr;
+	napi_typedarray_type type;
+	size_t length;
+	napi_value arrayBuffer;
+	size_t byteOffset;
+	napi_get_typedarray_info(env, args[1], &type, &length, (void**) &readCompletions->completedIds, &arrayBuffer, &byteOffset);
+	readCompletions->completedIdsSize = length;
+	napi_create_reference(env, args[1], 1, &readCompletions->completedIdsReference);
+	napi_value resource;
+	napi_status status = napi_create_object(env, &resource);
+	napi_value resource_name;
+	status = napi_create_string_latin1(env, "read", NAPI_AUTO_LENGTH, &resource_name);
+	napi_create_threadsafe_function(env, args[0], resource, resource_name, 0, 1, nullptr, nullptr, readCompletions,
+		read_complete, &readCompletions->callback);
+	// we only want to keep the event loop alive while reads are outstanding
+	napi_unref_threadsafe_function(env, readCompletions->callback);
+	startReadThreads();
 	RETURN_UNDEFINED;
 }
+void queueRead(napi_env env, read_instruction_t* readInstruction) {
+	readInstruction->buffers = EnvWrap::sharedBuffers;
+	readInstruction->completions = readCompletions;
+	readInstruction->resultsBuffer = nullptr;
+	readInstruction->next = nullptr;
+	if (readCompletions->outstanding++ == 0)
+		napi_ref_threadsafe_function(env, readCompletions->callback);
+	pthread_mutex_lock(readQueueLock);
+	if (readQueueTail)
+		readQueueTail->next = readInstruction;
+	else
+		readQueueHead = readInstruction;
+	readQueueTail = readInstruction;
+	pthread_cond_signal(readQueueCond);
+	pthread_mutex_unlock(readQueueLock);
+}
 NAPI_FUNCTION(startRead) {
 	ARGS(4)
 	GET_INT64_ARG(0);
 	uint32_t* instructionAddress = (uint32_t*) i64;
+	if (!readCompletions)
+		THROW_ERROR("No read callback has been set");
 	read_instruction_t* readInstruction = new read_instruction_t;
 	readInstruction->instructionAddress = instructionAddress;
 	uint32_t callback_id;
 	GET_UINT32_ARG(callback_id, 1);
-	//napi_create_reference(env, args[1], 1, &readInstruction->callback);
 	readInstruction->callback_id = callback_id;
-	readInstruction->buffers = EnvWrap::sharedBuffers;
-	napi_status status;
-	status = napi_create_async_work(env, args[2], args[3], do_read, read_complete, readInstruction, &readInstruction->work);
-	status = napi_queue_async_work(env, readInstruction->work);
+	readInstruction->cursor = nullptr;
+	queueRead(env, readInstruction);
+	RETURN_UNDEFINED;
+}
+/*
+	Iterates the next batch of entries from a positioned cursor on a read thread, so that multiple cursors (on
+	different parts of a range) can be read in parallel. The cursor and its txn must not be used by the JS thread
+	until the callback is called.
+*/
+NAPI_FUNCTION(startIterateBatch) {
+	ARGS(5)
+	GET_INT64_ARG(0);
+	CursorWrap* cw = (CursorWrap*) i64;
+	if (!readCompletions)
+		THROW_ERROR("No read callback has been set");
+	read_instruction_t* readInstruction = new read_instruction_t;
+	readInstruction->cursor = cw;
+	napi_get_value_int64(env, args[1], &i64);
+	readInstruction->instructionAddress = (uint32_t*) i64;
+	GET_UINT32_ARG(readInstruction->batchSize, 2);
+	GET_UINT32_ARG(readInstruction->maxEntries, 3);
+	GET_UINT32_ARG(readInstruction->callback_id, 4);
+	queueRead(env, readInstruction);
 	RETURN_UNDEFINED;
 }/*
 NAPI_FUNCTION(nextRead) {
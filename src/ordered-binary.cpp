@@ -7,6 +7,56 @@
 #include <arpa/inet.h>
 #endif
 
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define SIMD_COMPARE
+#ifdef _MSC_VER
+#include <intrin.h>
+static inline unsigned int countTrailingZeros(unsigned int mask) {
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+}
+#else
+#define countTrailingZeros __builtin_ctz
+#endif
+/*
+	Finds the offset of the first differing byte in the 16-byte blocks of the given size, returning the size rounded down
+	to 16 if there is no difference. SSE2 is always available on x64, and AVX2 (32 bytes at a time) is used if the CPU
+	supports it (detected at startup).
+*/
+static size_t firstDifferenceSSE2(const uint8_t* a, const uint8_t* b, size_t size) {
+    size_t offset = 0;
+    for (; offset + 16 <= size; offset += 16) {
+        unsigned int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) (a + offset)),
+            _mm_loadu_si128((const __m128i*) (b + offset))));
+        if (mask != 0xffff)
+            return offset + countTrailingZeros(~mask);
+    }
+    return offset;
+}
+#if defined(__GNUC__)
+__attribute__((target("avx2")))
+static size_t firstDifferenceAVX2(const uint8_t* a, const uint8_t* b, size_t size) {
+    size_t offset = 0;
+    for (; offset + 32 <= size; offset += 32) {
+        unsigned int mask = (unsigned int) _mm256_movemask_epi8(_mm256_cmpeq_epi8(
+            _mm256_loadu_si256((const __m256i*) (a + offset)), _mm256_loadu_si256((const __m256i*) (b + offset))));
+        if (mask != 0xffffffff)
+            return offset + countTrailingZeros(~mask);
+    }
+    return offset + firstDifferenceSSE2(a + offset, b + offset, size - offset);
+}
+static size_t (*selectFirstDifference())(const uint8_t*, const uint8_t*, size_t) {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? firstDifferenceAVX2 : firstDifferenceSSE2;
+}
+static size_t (*firstDifference)(const uint8_t*, const uint8_t*, size_t) = selectFirstDifference();
+#else
+#define firstDifference firstDifferenceSSE2
+#endif
+#endif
+
 // compare items by 32-bit comparison, a is user provided and assumed to be zero terminated/padded
 // which allows us to do the full 32-bit comparisons safely
 int compareFast(const MDB_val *a, const MDB_val *b) {
@@ -14,6 +64,19 @@ int compareFast(const MDB_val *a, const MDB_val *b) {
     uint32_t* dataB = (uint32_t*) b->mv_data;
     size_t remaining = b->mv_size;
     uint32_t aVal, bVal;
+#ifdef SIMD_COMPARE
+    if (remaining >= 16) {
+        // long (composite) keys, find the first difference with vector comparisons
+        size_t offset = firstDifference((uint8_t*) dataA, (uint8_t*) dataB, remaining);
+        size_t blocks = remaining & ~((size_t) 15);
+        if (offset < blocks)
+            return ((uint8_t*) dataA)[offset] > ((uint8_t*) dataB)[offset] ? 1 : -1;
+        // and finish the remaining bytes with 32-bit comparisons
+        dataA += blocks >> 2;
+        dataB += blocks >> 2;
+        remaining -= blocks;
+    }
+#endif
     while(remaining >= 4) {
         aVal = ntohl(*dataA);
         bVal = ntohl(*dataB);
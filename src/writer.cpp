@@ -13,6 +13,7 @@ inline value?
 */
 #include "lmdb-js.h"
 #include <atomic>
+#include <algorithm>
 #include <ctime>
 #ifndef _WIN32
 #include <unistd.h>
@@ -114,6 +115,44 @@ void WriteWorker::UnlockTxn() {
 	pthread_cond_signal(envForTxn->writingCond);
 	pthread_mutex_unlock(envForTxn->writingLock);
 }
+/*
+	Called when the instructions have run out and the batch could be committed. If the writes have been arriving
+	faster than they can be committed (so there is a batch hold time), this waits up to the hold time (within the
+	latency budget of the transaction) for another write, to grow the batch rather than committing a tiny one.
+	Returns true if another instruction has arrived and should be written in this transaction.
+*/
+bool WriteWorker::HoldBatch(uint32_t* target) {
+	uint64_t now = get_time64();
+	uint64_t elapsed = now - txnStartTime;
+	if (elapsed >= envForTxn->commitLatencyBudget)
+		return false;
+	uint64_t deadline = now + std::min(envForTxn->batchHoldTime, envForTxn->commitLatencyBudget - elapsed);
+	uint32_t flags = NO_INSTRUCTION_YET;
+	if (!std::atomic_compare_exchange_strong((std::atomic<uint32_t>*) target, &flags, (uint32_t) WAITING_OPERATION))
+		return true; // an instruction was just written
+	do {
+		interruptionStatus = WORKER_WAITING;
+		cond_timedwait(envForTxn->writingCond, envForTxn->writingLock, (deadline - now) / TICKS_PER_TIMED_WAIT + 1);
+		if (*target & 0xf) {
+			interruptionStatus = 0;
+			return true;
+		}
+		if (interruptionStatus == INTERRUPT_BATCH)
+			break; // a synchronous transaction is waiting, commit now (and it will follow)
+		now = get_time64();
+	} while (now < deadline);
+	if (interruptionStatus != INTERRUPT_BATCH)
+		interruptionStatus = 0;
+	flags = WAITING_OPERATION;
+	if (!std::atomic_compare_exchange_strong((std::atomic<uint32_t>*) target, &flags, NO_INSTRUCTION_YET))
+		return true; // it arrived as we were finishing
+	// nothing came in while holding, so the load is dropping, hold for less next time
+	envForTxn->batchHoldTime >>= 1;
+	if (envForTxn->batchHoldTime < TICKS_PER_TIMED_WAIT)
+		envForTxn->batchHoldTime = 0;
+	return false;
+}
+
 int WriteWorker::WaitForCallbacks(MDB_txn** txn, bool allowCommit, uint32_t* target) {
 	int rc;
 	if (!finishedProgress)
@@ -175,6 +214,38 @@ int WriteWorker::WaitForCallbacks(MDB_txn** txn, bool allowCommit, uint32_t* tar
 		interruptionStatus = 0;
 	return 0;
 }
+#ifdef MDB_RPAGE_CACHE
+struct CompressInPlace {
+	Compression* compression;
+	MDB_val* value;
+	double* version;
+};
+static size_t fillCompressed(MDB_val* target, void* context) {
+	CompressInPlace* compressInPlace = (CompressInPlace*) context;
+	size_t offset = 0;
+	if (compressInPlace->version) {
+		memcpy(target->mv_data, compressInPlace->version, 8);
+		offset = 8;
+	}
+	size_t size = compressInPlace->compression->compressInto((char*) compressInPlace->value->mv_data,
+		compressInPlace->value->mv_size, (char*) target->mv_data + offset, target->mv_size - offset);
+	// a size larger than the reserved space indicates that it failed
+	return size ? size + offset : target->mv_size + 1;
+}
+/*
+	Puts a value by reserving space for the compression bound in the page and compressing directly into it, and then
+	trimming it to the compressed size, which avoids copying the compressed value (on the write thread).
+*/
+static int putCompressed(MDB_txn* txn, MDB_dbi dbi, MDB_val* key, MDB_val* value, unsigned int flags,
+		Compression* compression, double* version) {
+	CompressInPlace context = { compression, value, version };
+	MDB_val reserved;
+	reserved.mv_size = compression->compressedBound(value->mv_size) + (version ? 8 : 0);
+	reserved.mv_data = nullptr;
+	return mdb_put_fill(txn, dbi, key, &reserved, flags, fillCompressed, &context);
+}
+#endif
+
 int WriteWorker::DoWrites(MDB_txn* txn, EnvWrap* envForTxn, uint32_t* instruction, WriteWorker* worker) {
 	MDB_val key, value;
 	int rc = 0;
@@ -187,6 +258,9 @@ int WriteWorker::DoWrites(MDB_txn* txn, EnvWrap* envForTxn, uint32_t* instructio
 next_inst:	start = instruction++;
 		uint32_t flags = *start;
 		MDB_dbi dbi = 0;
+		void* compressedData = nullptr; // released once the instruction is finished
+		Compression* compressInPlace = nullptr;
+		double* compressionAddress = nullptr;
 		//fprintf(stderr, "do %u %u\n", flags, get_time64());
 		bool validated = conditionDepth == validatedDepth;
 		if (flags & 0xc0c0) {
@@ -207,19 +281,54 @@ next_inst:	start = instruction++;
 					status = std::atomic_exchange((std::atomic<int64_t>*)(instruction + 2), (int64_t)1);
 					if (status == 2) {
 						//fprintf(stderr, "wait on compression %p\n", instruction);
+						envForTxn->compressionStalls++;
+#ifdef MDB_TRACK_METRICS
+						uint64_t start = get_time64();
+#endif
 						worker->interruptionStatus = WORKER_WAITING;
-						do {
-							pthread_cond_wait(envForTxn->writingCond, envForTxn->writingLock);
-						} while (std::atomic_load((std::atomic<int64_t>*)(instruction + 2)));
+						std::atomic<int64_t>* compressionStatus = (std::atomic<int64_t>*)(instruction + 2);
+						int64_t waiting = 1;
+						// Rather than sitting idle, compress the upcoming values that are still queued, since we will
+						// need them next. While doing that, this value is marked as not waited on (2), so its compression
+						// thread doesn't need the writing lock to signal us when it finishes.
+						if (compressionStatus->compare_exchange_strong(waiting, 2)) {
+							pthread_mutex_unlock(envForTxn->writingLock);
+							while (compressionStatus->load() && Compression::compressQueued(envForTxn)) {}
+							pthread_mutex_lock(envForTxn->writingLock);
+							if (compressionStatus->exchange(1)) {
+								do {
+									pthread_cond_wait(envForTxn->writingCond, envForTxn->writingLock);
+								} while (compressionStatus->load());
+							}
+						}
 						worker->interruptionStatus = 0;
+#ifdef MDB_TRACK_METRICS
+						envForTxn->timeCompressionWaiting += get_time64() - start;
+#endif
 					} else if (status > 2) {
 						//fprintf(stderr, "doing the compression ourselves\n");
-						((Compression*) (size_t) *((double*)&status))->compressInstruction(nullptr, (double*) (instruction + 2));
+						// the compression threads haven't gotten to it (or it was never queued), make sure they don't
+						Compression::cancelCompression(envForTxn, (double*) (instruction + 2));
+						envForTxn->writerCompressions++;
+						Compression* compression = (Compression*) (size_t) *((double*)&status);
+#ifdef MDB_RPAGE_CACHE
+						// a plain put can be compressed directly into the reserved space in the page
+						if ((flags & 0xf) == PUT && !(flags & (ASSIGN_TIMESTAMP | MDB_NODUPDATA | MDB_APPENDDUP)))
+							compressInPlace = compression;
+						else
+#endif
+							compression->compressInstruction(nullptr, (double*) (instruction + 2));
 					} // else status is 0 and compression is done
-					// compressed
-					value.mv_data = (void*)(size_t) * ((size_t*)instruction);
-					if ((size_t)value.mv_data > 0x1000000000000)
-						fprintf(stderr, "compression not completed %p %i\n", value.mv_data, (int) status);
+					compressionAddress = (double*) (instruction + 2);
+					if (compressInPlace) // still uncompressed
+						value.mv_data = (void*)(size_t) * ((double*)instruction);
+					else {
+						// compressed
+						value.mv_data = (void*)(size_t) * ((size_t*)instruction);
+						if ((size_t)value.mv_data > 0x1000000000000)
+							fprintf(stderr, "compression not completed %p %i\n", value.mv_data, (int) status);
+						compressedData = value.mv_data;
+					}
 					value.mv_size = *(instruction - 1);
 					instruction += 4; // skip compression pointers
 				} else {
@@ -276,6 +385,8 @@ next_inst:	start = instruction++;
 					}
 					goto next_inst;
 				} else {
+					if (worker->envForTxn->batchHoldTime && worker->HoldBatch(start))
+						goto next_inst;
 					if (std::atomic_compare_exchange_strong((std::atomic<uint32_t>*) start,
 							(uint32_t*) &flags,
 							(uint32_t)TXN_DELIMITER)) {
@@ -358,21 +469,30 @@ next_inst:	start = instruction++;
 						}
 					}
 				}
+#endif
+#ifdef MDB_RPAGE_CACHE
+				if (compressInPlace) {
+					rc = putCompressed(txn, dbi, &key, &value, flags & (MDB_NOOVERWRITE | MDB_APPEND), compressInPlace,
+						(flags & SET_VERSION) ? &setVersion : nullptr);
+					if (rc != MDB_INCOMPATIBLE && rc != MDB_PAGE_FULL)
+						break;
+					// can't be filled in place (dupsort, too large for a leaf node, or the reserved space would split the
+					// page), so compress into a buffer and put that
+					compressInPlace->compressInstruction(nullptr, compressionAddress);
+					value.mv_data = compressedData = (void*)(size_t) * ((size_t*)(compressionAddress - 1));
+					value.mv_size = *(((uint32_t*)compressionAddress) - 3);
+				}
 #endif
 				if (flags & SET_VERSION)
 					rc = putWithVersion(txn, dbi, &key, &value, flags & (MDB_NOOVERWRITE | MDB_NODUPDATA | MDB_APPEND | MDB_APPENDDUP), setVersion);
 				else
 					rc = mdb_put(txn, dbi, &key, &value, flags & (MDB_NOOVERWRITE | MDB_NODUPDATA | MDB_APPEND | MDB_APPENDDUP));
-				if (flags & COMPRESSIBLE)
-					delete value.mv_data;
 				break;
 			case DEL:
 				rc = mdb_del(txn, dbi, &key, nullptr);
 				break;
 			case DEL_VALUE:
 				rc = mdb_del(txn, dbi, &key, &value);
-				if (flags & COMPRESSIBLE)
-					delete value.mv_data;
 				break;
 			case START_BLOCK: case START_CONDITION_BLOCK:
 				rc = validated ? 0 : MDB_NOTFOUND;
@@ -403,6 +523,8 @@ next_inst:	start = instruction++;
 				worker->resultCode = 22;
 				abort();
 			}
+			if (compressedData) // the compressed value has been copied by LMDB, return it to its arena
+				Compression::releaseCompressed(compressedData);
 			if (rc) {
 				if (!(rc == MDB_KEYEXIST || rc == MDB_NOTFOUND)) {
 					if (worker) {
@@ -415,8 +537,11 @@ next_inst:	start = instruction++;
 			}
 			else
 				flags = FINISHED_OPERATION;
-		} else
+		} else {
+			if (compressedData) // the compressed value won't be written
+				Compression::releaseCompressed(compressedData);
 			flags = FINISHED_OPERATION | FAILED_CONDITION;
+		}
 		//fprintf(stderr, "finished flag %p\n", flags);
 		if (overlappedWord) {
 			std::atomic_fetch_or((std::atomic<uint32_t>*) start, flags);
@@ -487,6 +612,16 @@ void WriteWorker::Write() {
 		resultCode = rc;
 		return;
 	}
+	if (envForTxn->commitLatencyBudget) {
+		txnStartTime = get_time64();
+		// if the writes queued up while the last batch was committing, we are under load, and holding the transaction
+		// open for more writes (rather than committing as soon as they run out) will reduce the number of commits
+		if (envForTxn->lastCommitEnd && txnStartTime - envForTxn->lastCommitEnd < envForTxn->commitLatency) {
+			uint64_t holdTime = envForTxn->batchHoldTime ? envForTxn->batchHoldTime << 1 : envForTxn->commitLatency >> 2;
+			envForTxn->batchHoldTime = std::min(std::max(holdTime, TICKS_PER_TIMED_WAIT), envForTxn->commitLatencyBudget);
+		} else if (txnStartTime - envForTxn->lastCommitEnd > envForTxn->commitLatencyBudget)
+			envForTxn->batchHoldTime = 0; // idle, commit immediately
+	}
 	uint32_t* start = instructions;
 	rc = DoWrites(txn, envForTxn, instructions, this);
 	uint32_t txnId = (uint32_t) mdb_txn_id(txn);
@@ -503,6 +638,7 @@ void WriteWorker::Write() {
 		fprintf(stderr, "do_write error %u %u\n", rc, resultCode);
 		mdb_txn_abort(txn);
 	} else {
+		uint64_t commitStart = envForTxn->commitLatencyBudget ? get_time64() : 0;
 		rc = mdb_txn_commit(txn);
 #ifdef MDB_EMPTY_TXN
 		if (rc == MDB_EMPTY_TXN)
@@ -513,6 +649,11 @@ void WriteWorker::Write() {
 #else
 		had_changes = true;
 #endif
+		if (commitStart) {
+			envForTxn->lastCommitEnd = get_time64();
+			uint64_t latency = envForTxn->lastCommitEnd - commitStart;
+			envForTxn->commitLatency = envForTxn->commitLatency ? (envForTxn->commitLatency * 7 + latency) >> 3 : latency;
+		}
 	}
 	if (!(*instructions & TXN_DELIMITER))
 		fprintf(stderr, "end write %p, next start %p NOT still valid %p\n", start, instructions, *instructions);
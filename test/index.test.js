@@ -5,6 +5,7 @@ import rimraf from 'rimraf';
 let should = chai.should();
 let expect = chai.expect;
 import { spawn } from 'node:child_process';
+import { randomBytes } from 'node:crypto';
 import { unlinkSync } from 'node:fs';
 import { fileURLToPath } from 'node:url';
 import { Worker } from 'node:worker_threads';
@@ -19,9 +20,11 @@ import {
 	IF_EXISTS,
 	asBinary,
 	bufferToKeyValue,
+	getLastVersion,
 	keyValueToBuffer,
 	levelup,
 	open,
+	openSharded,
 	version,
 	TIMESTAMP_PLACEHOLDER,
 	DIRECT_WRITE_PLACEHOLDER,
@@ -592,6 +595,82 @@ describe('lmdb-js', function () {
 				);
 				result.should.deep.equal([{ key: ['foo', 2], value: 2 }]);
 			});
+			it('keys with a key prefix', async function () {
+				let dbPrefix = db.openDB({
+					name: 'mydb-key-prefix',
+					keyPrefix: ['tenant-1', 'orders'],
+				});
+				let promise;
+				for (let i = 0; i < 10; i++)
+					promise = dbPrefix.put(['tenant-1', 'orders', i], 'order ' + i);
+				await promise;
+				dbPrefix.get(['tenant-1', 'orders', 3]).should.equal('order 3');
+				let result = Array.from(
+					dbPrefix.getRange({
+						start: ['tenant-1', 'orders', 2],
+						end: ['tenant-1', 'orders', 5],
+					}),
+				);
+				result.should.deep.equal([
+					{ key: ['tenant-1', 'orders', 2], value: 'order 2' },
+					{ key: ['tenant-1', 'orders', 3], value: 'order 3' },
+					{ key: ['tenant-1', 'orders', 4], value: 'order 4' },
+				]);
+				Array.from(dbPrefix.getKeys({ reverse: true }))[0].should.deep.equal([
+					'tenant-1',
+					'orders',
+					9,
+				]);
+				(() => dbPrefix.get(['tenant-2', 'orders', 3])).should.throw();
+				// the saved prefix is not part of any range
+				Array.from(dbPrefix.getKeys({ start: ['tenant-1', 'orders'] }))
+					.length.should.equal(10);
+				Array.from(
+					dbPrefix.getKeys({ end: ['tenant-1', 'orders', 2] }),
+				).should.deep.equal([
+					['tenant-1', 'orders', 0],
+					['tenant-1', 'orders', 1],
+				]);
+				dbPrefix.getCount().should.equal(10);
+				dbPrefix.getCount({ start: ['tenant-1', 'orders'] }).should.equal(10);
+				dbPrefix.getAggregate().count.should.equal(10);
+				Array.from(dbPrefix.getKeys({ reverse: true })).length.should.equal(10);
+				(() =>
+					db.openDB({
+						name: 'mydb-key-prefix',
+						keyPrefix: ['tenant-2', 'orders'],
+					})).should.throw();
+			});
+			it('orders long keys the same as a byte comparison', async function () {
+				// keys of 16 bytes or more are compared with vector comparisons, with differences in the first 16-byte
+				// block, the following (32-byte) blocks, and in the tail after the last full block
+				let simdDb = db.openDB('simd-compare', {});
+				let base = 'k' + 'x'.repeat(63);
+				let lengths = [16, 17, 20, 31, 32, 33, 47, 48, 50, 63, 64];
+				let keySet = new Set();
+				for (let position = 0; position < 64; position++) {
+					for (let char of ['a', 'm', 'z']) {
+						let key = base.slice(0, position) + char + base.slice(position + 1);
+						for (let length of lengths)
+							if (length > position) keySet.add(key.slice(0, length));
+					}
+				}
+				let keys = Array.from(keySet).sort();
+				let lastPromise;
+				for (let key of keys) lastPromise = simdDb.put(key, key);
+				await lastPromise;
+				Array.from(simdDb.getKeys()).should.deep.equal(keys);
+				for (let key of keys) {
+					simdDb.get(key).should.equal(key);
+					// a key (of a length that isn't stored) between the stored keys
+					let probe = key.slice(0, 40);
+					if (keySet.has(probe)) continue;
+					should.equal(simdDb.get(probe), undefined);
+					let next = keys.find((stored) => stored > probe);
+					let first = Array.from(simdDb.getKeys({ start: probe, limit: 1 }));
+					should.equal(first[0], next);
+				}
+			});
 			it('should iterate over query with offset/limit', async function () {
 				let data1 = { foo: 1, bar: true };
 				let data2 = { foo: 2, bar: false };
@@ -926,6 +1005,7 @@ describe('lmdb-js', function () {
 					for (let i = 0; i < 200; i++) {
 						should.equal(results[i], 'value' + i);
 					}
+					should.equal(await db.getAsync('async-missing'), undefined);
 				});
 			it('getUserSharedBuffer', function () {
 				let defaultIncrementer = new BigInt64Array(1);
@@ -996,6 +1076,174 @@ describe('lmdb-js', function () {
 				]);
 			});
 
+			it('getManySync', async function () {
+				await db.put('many1', 'value1');
+				await db.put('many2', { name: 'value2' });
+				let large = 'x'.repeat(100000);
+				await db.put('many3', large);
+				let values = db.getManySync([
+					'many1',
+					'does-not-exist',
+					'many2',
+					'many3',
+				]);
+				should.equal(values.length, 4);
+				should.equal(values[0], 'value1');
+				should.equal(values[1], undefined);
+				should.equal(values[2].name, 'value2');
+				should.equal(values[3], large);
+				let keys = [];
+				for (let i = 0; i < 3000; i++) keys.push(i % 2 ? 'many1' : 'many2');
+				values = db.getManySync(keys);
+				should.equal(values.length, 3000);
+				should.equal(values[2999], 'value1');
+				should.equal(values[2998].name, 'value2');
+				should.equal(db.getManySync([]).length, 0);
+				await db.put('many-versioned', 'value', 4321);
+				db.getManySync(['many1', 'many-versioned']);
+				should.equal(getLastVersion(), 4321);
+			});
+			it('getManySync with sorted keys', async function () {
+				for (let i = 0; i < 100; i++) db.put('sorted-' + (1000 + i * 2), i);
+				await db.committed;
+				let keys = [];
+				for (let i = 0; i < 200; i += 3) keys.push('sorted-' + (1200 - i));
+				keys.push('sorted-zzz', 'a-sorted', 'sorted-1000', 'sorted-1000');
+				let values = db.getManySync(keys, { sortKeys: true });
+				should.equal(values.length, keys.length);
+				for (let i = 0; i < keys.length; i++) {
+					let n = +keys[i].slice(7);
+					let expected =
+						n >= 1000 && n <= 1198 && n % 2 == 0 ? (n - 1000) / 2 : undefined;
+					should.equal(values[i], expected);
+				}
+			});
+
+			it('range iteration in batches', async function () {
+				let large = 'y'.repeat(50000);
+				for (let i = 0; i < 2000; i++)
+					db.put(['batch', i], i == 1000 ? large : { i, text: 'entry ' + i });
+				await db.committed;
+				let options = { start: ['batch', 0], end: ['batch', 2000] };
+				let entries = db.getRange(options).asArray;
+				let unbatched = db.getRange({ ...options, batch: false }).asArray;
+				should.equal(entries.length, 2000);
+				should.equal(unbatched.length, 2000);
+				for (let i = 0; i < 2000; i++) {
+					should.equal(entries[i].key[1], i);
+					if (i == 1000) should.equal(entries[i].value, large);
+					else should.equal(entries[i].value.text, 'entry ' + i);
+					should.equal(entries[i].key[1], unbatched[i].key[1]);
+				}
+				let keys = db.getKeys({
+					start: ['batch', 2000],
+					end: ['batch', 0],
+					reverse: true,
+					limit: 1500,
+				}).asArray;
+				should.equal(keys.length, 1500);
+				should.equal(keys[0][1], 1999);
+				should.equal(keys[1499][1], 500);
+			});
+
+			it('parallel range scan', async function () {
+				let large = 'y'.repeat(50000);
+				for (let i = 0; i < 3000; i++)
+					db.put(['parallel', i], i == 1500 ? large : { i });
+				await db.committed;
+				let options = { start: ['parallel', 0], end: ['parallel', 3000] };
+				let splits = db.getRangeSplits(options, 4);
+				should.equal(splits.length > 0, true);
+				for (let split of splits) should.equal(split[0], 'parallel');
+				let keys = [];
+				for await (let { key, value } of db.getRangeParallel({
+					...options,
+					parts: 4,
+				})) {
+					keys.push(key[1]);
+					if (key[1] == 1500) should.equal(value, large);
+					else should.equal(value.i, key[1]);
+				}
+				should.equal(keys.length, 3000);
+				for (let i = 0; i < 3000; i++) should.equal(keys[i], i);
+				let unordered = [];
+				for await (let key of db.getRangeParallel({
+					...options,
+					values: false,
+					ordered: false,
+				}))
+					unordered.push(key[1]);
+				should.equal(unordered.length, 3000);
+				unordered.sort((a, b) => a - b);
+				for (let i = 0; i < 3000; i++) should.equal(unordered[i], i);
+				let limited = [];
+				for await (let entry of db.getRangeParallel({ ...options, limit: 10 }))
+					limited.push(entry);
+				should.equal(limited.length, 10);
+			});
+			it('range aggregates', async function () {
+				let dbAggregate = db.openDB({
+					name: 'mydb-aggregate',
+					encoding: 'binary',
+				});
+				for (let i = 0; i < 100; i++) {
+					let value = Buffer.alloc(12);
+					value.writeDoubleLE(i * 1.5, 4);
+					await dbAggregate.put(['agg', i], value);
+				}
+				let options = { start: ['agg', 10], end: ['agg', 20] };
+				let aggregate = dbAggregate.getAggregate({
+					...options,
+					valueOffset: 4,
+					valueType: 'float64',
+				});
+				should.equal(aggregate.count, 10);
+				should.equal(aggregate.valueBytes, 120);
+				should.equal(aggregate.minKey[1], 10);
+				should.equal(aggregate.maxKey[1], 19);
+				should.equal(aggregate.valueCount, 10);
+				should.equal(aggregate.sum, 217.5);
+				should.equal(aggregate.min, 15);
+				should.equal(aggregate.max, 28.5);
+				let reverse = dbAggregate.getAggregate({
+					start: ['agg', 20],
+					end: ['agg', 10],
+					reverse: true,
+				});
+				should.equal(reverse.count, 10);
+				should.equal(reverse.minKey[1], 11);
+				should.equal(reverse.maxKey[1], 20);
+				should.equal(reverse.sum, undefined);
+				let empty = dbAggregate.getAggregate({ start: ['none'] });
+				should.equal(empty.count, 0);
+				should.equal(empty.minKey, undefined);
+			});
+			it('count and offset across many pages', async function () {
+				for (let i = 0; i < 5000; i++) db.put(['paged', i], i);
+				await db.committed;
+				should.equal(
+					db.getCount({ start: ['paged', 100], end: ['paged', 4900] }),
+					4800,
+				);
+				should.equal(
+					db.getCount({
+						start: ['paged', 100],
+						end: ['paged', 4900],
+						inclusiveEnd: true,
+					}),
+					4801,
+				);
+				should.equal(db.getCount({ start: ['paged', 4000] }) >= 1000, true);
+				let entries = db
+					.getRange({ start: ['paged', 0], offset: 3210, limit: 2 })
+					.asArray;
+				should.equal(entries[0].value, 3210);
+				should.equal(entries[1].value, 3211);
+				should.equal(
+					db.getRange({ start: ['paged', 0], offset: 100000 }).asArray.length,
+					0,
+				);
+			});
 			it('invalid key', async function () {
 				expect(() => db.get(Buffer.from([]))).to.throw();
 				expect(() => db.put(Buffer.from([]), 'test')).to.throw();
@@ -1645,6 +1893,152 @@ describe('lmdb-js', function () {
 				});
 			});
 
+			it('lz4hc compression codec', async function () {
+				let dbHC = db.openDB({
+					name: 'mydb-lz4hc',
+					compression: { codec: 'lz4hc', level: 12, threshold: 100 },
+				});
+				let value = { text: 'compress me with lz4hc '.repeat(100) };
+				await dbHC.put('hc', value);
+				dbHC.get('hc').text.should.equal(value.text);
+				expect(() =>
+					db.openDB({ name: 'mydb-bad-codec', compression: { codec: 'nope' } }),
+				).to.throw();
+			});
+			it('compress in place in a synchronous transaction', function () {
+				let dbInPlace = db.openDB({
+					name: 'mydb-in-place',
+					useVersions: true,
+					compression: { threshold: 100 },
+				});
+				let text = 'compress directly into the page '.repeat(20);
+				dbInPlace.transactionSync(() => {
+					for (let i = 0; i < 100; i++)
+						dbInPlace.put(i, { text: text + i }, i + 1);
+				});
+				for (let i = 0; i < 100; i += 11) {
+					let entry = dbInPlace.getEntry(i);
+					entry.value.text.should.equal(text + i);
+					entry.version.should.equal(i + 1);
+				}
+			});
+			it('compress in place over existing values', function () {
+				let dbInPlace = db.openDB({
+					name: 'mydb-in-place-overwrite',
+					compression: { threshold: 100 },
+				});
+				let random = (size) => randomBytes(size).toString('base64');
+				let text = 'replaced with a smaller value '.repeat(10);
+				dbInPlace.transactionSync(() => {
+					// large values (in overflow pages) and compressible values
+					for (let i = 0; i < 50; i++) {
+						dbInPlace.put(i, { text: random(8000) });
+						dbInPlace.put(i + 50, { text: text.repeat(4) + i });
+					}
+				});
+				dbInPlace.transactionSync(() => {
+					for (let i = 0; i < 100; i++) dbInPlace.put(i, { text: text + i });
+				});
+				for (let i = 0; i < 100; i++)
+					dbInPlace.get(i).text.should.equal(text + i);
+			});
+			it('compression pool with many async writes', async function () {
+				let dbPool = db.openDB({
+					name: 'mydb-compression-pool',
+					compression: { threshold: 100 },
+				});
+				let text = 'compressed by the compression threads '.repeat(20);
+				let lastPut;
+				// more than fit in the compression queue, so the write thread has to help
+				for (let i = 0; i < 3000; i++) lastPut = dbPool.put(i, { text: text + i });
+				await lastPut;
+				for (let i = 0; i < 3000; i += 97)
+					dbPool.get(i).text.should.equal(text + i);
+				let stats = db.getStats();
+				stats.compressionStalls.should.be.a('number');
+				stats.writerCompressions.should.be.a('number');
+			});
+			it('compression pool with concurrently queued values', async function () {
+				let dbs = [0, 1, 2].map((i) =>
+					db.openDB({
+						name: 'mydb-compression-concurrent-' + i,
+						compression: { threshold: 100 },
+					}),
+				);
+				let text = 'compressed while other values are queued '.repeat(20);
+				let before = db.getStats();
+				// many compressible puts queued at once across the databases, more than fit in the compression queue
+				let puts = [];
+				for (let i = 0; i < 1500; i++)
+					for (let dbPool of dbs) puts.push(dbPool.put(i, { text: text + i }));
+				// values written in a synchronous transaction are compressed by the writing thread
+				dbs[0].transactionSync(() => {
+					for (let i = 1500; i < 1600; i++)
+						dbs[0].put(i, { text: text + i });
+				});
+				await Promise.all(puts);
+				for (let dbPool of dbs) {
+					let count = dbPool === dbs[0] ? 1600 : 1500;
+					for (let i = 0; i < count; i++)
+						dbPool.get(i).text.should.equal(text + i);
+				}
+				let stats = db.getStats();
+				stats.writerCompressions.should.be.at.least(
+					before.writerCompressions + 100,
+				);
+				stats.compressionStalls.should.be.at.least(before.compressionStalls);
+			});
+			it('large and partial decompression', async function () {
+				let dbLarge = db.openDB({
+					name: 'mydb-large-compressed',
+					encoding: 'binary',
+					compression: { threshold: 100 },
+				});
+				let value = Buffer.from(
+					'a large compressible document. '.repeat(100000),
+				);
+				await dbLarge.put('large', value);
+				dbLarge.getBinary('large').equals(value).should.be.true;
+				let header = Buffer.alloc(20);
+				dbLarge.getBinaryInto('large', header).should.equal(value.length);
+				header.toString().should.equal(value.subarray(0, 20).toString());
+				should.equal(dbLarge.getBinaryInto('missing', header), undefined);
+				// values larger than the decompression buffer read through a cursor
+				let medium = Buffer.from('a medium compressible document. '.repeat(1500));
+				await dbLarge.put('medium', medium);
+				for (let { key, value: rangeValue } of dbLarge.getRange()) {
+					rangeValue
+						.equals(key == 'large' ? value : medium)
+						.should.equal(true);
+				}
+			});
+			it('train and version dictionaries', async function () {
+				let dbDict = db.openDB({
+					name: 'mydb-dictionary',
+					compression: { threshold: 100 },
+				});
+				for (let i = 0; i < 200; i++) {
+					await dbDict.put(i, {
+						name: 'user' + i,
+						email: 'user' + i + '@example.com',
+						description: 'a sample record with a long description '.repeat(4),
+					});
+				}
+				let dictionary = dbDict.trainDictionary({ size: 4096 });
+				dictionary.length.should.be.greaterThan(0);
+				dictionary.length.should.be.at.most(4096);
+				let dbVersioned = db.openDB({
+					name: 'mydb-dictionary',
+					compression: { threshold: 100, dictionaries: [dictionary] },
+				});
+				await dbVersioned.put('new', {
+					name: 'new user',
+					description: 'a sample record with a long description '.repeat(4),
+				});
+				// old records are still decompressed with the base dictionary
+				dbVersioned.get(5).email.should.equal('user5@example.com');
+				dbVersioned.get('new').name.should.equal('new user');
+			});
 			it('direct write', async function () {
 				let dbBinary = db.openDB(
 					Object.assign({
@@ -1826,6 +2220,119 @@ describe('lmdb-js', function () {
 					if (db !== dbMirror) await dbMirror.close();
 				}
 			});
+			it('group sync across environments', async function () {
+				if (options.encryptionKey) return;
+				let dbs = [];
+				// more than the initial size of the sync group's lists (16), so they are grown while envs are flushed
+				for (let i = 0; i < 24; i++)
+					dbs.push(
+						open(testDirPath + '/group-sync-' + i + '.mdb', {
+							groupSync: true,
+						}),
+					);
+				for (let round = 0; round < 5; round++) {
+					await Promise.all(
+						dbs.map((db, i) => db.put('key', 'value ' + i + '-' + round)),
+					);
+				}
+				await Promise.all(dbs.map((db, i) => db.put('key', 'value ' + i)));
+				await Promise.all(dbs.map((db) => db.flushed));
+				for (let i = 0; i < 24; i++) {
+					dbs[i].get('key').should.equal('value ' + i);
+					await dbs[i].close();
+				}
+			});
+			it('sharded database', async function () {
+				let shardedDb = openSharded(testDirPath + '/sharded.mdb', {
+					shards: 3,
+					encryptionKey: options.encryptionKey,
+				});
+				for (let i = 0; i < 100; i++) shardedDb.put(i, 'value ' + i);
+				await shardedDb.committed;
+				shardedDb.get(42).should.equal('value 42');
+				shardedDb.shards.forEach((shard) =>
+					shard.getCount().should.be.lt(100),
+				);
+				shardedDb.getCount().should.equal(100);
+				let keys = shardedDb.getKeys({ start: 10, end: 20 }).asArray;
+				keys.should.deep.equal([10, 11, 12, 13, 14, 15, 16, 17, 18, 19]);
+				let entries = shardedDb
+					.getRange({ start: 90, end: 10, reverse: true, offset: 5, limit: 3 })
+					.asArray;
+				entries.map(({ key }) => key).should.deep.equal([85, 84, 83]);
+				entries[0].value.should.equal('value 85');
+				(await shardedDb.getMany([1, 50, 200])).should.deep.equal([
+					'value 1',
+					'value 50',
+					undefined,
+				]);
+				let ranged = shardedDb.openDB('ranged', { keyEncoding: 'uint32' });
+				await ranged.put(5, 'five');
+				ranged.getShard(5).get(5).should.equal('five');
+				ranged.getCount().should.equal(1);
+				await shardedDb.close();
+				let rangeSharded = openSharded(testDirPath + '/range-sharded.mdb', {
+					shardRanges: [50],
+					encryptionKey: options.encryptionKey,
+				});
+				await rangeSharded.put(60, 'sixty');
+				rangeSharded.shards[1].get(60).should.equal('sixty');
+				rangeSharded.getShardIndex(10).should.equal(0);
+				await rangeSharded.close();
+			});
+			it('low priority writes', async function () {
+				let lowPriorityDb = open(testDirPath + '/low-priority.mdb', {
+					lowPriorityBatchSize: 100,
+					encryptionKey: options.encryptionKey,
+				});
+				let bulk = lowPriorityDb.openDB('bulk', { writePriority: 'low' });
+				let bulkPromise;
+				for (let i = 0; i < 1000; i++) bulkPromise = bulk.put(i, 'bulk ' + i);
+				// a normal write doesn't wait for all the bulk writes
+				await lowPriorityDb.put('interactive', 'value');
+				should.equal(bulk.get(999), undefined);
+				let lowPromise = lowPriorityDb.put('low', 'value', { priority: 'low' });
+				(await bulkPromise).should.equal(true);
+				(await lowPromise).should.equal(true);
+				bulk.get(999).should.equal('bulk 999');
+				lowPriorityDb.get('low').should.equal('value');
+				await bulk.remove(999);
+				should.equal(bulk.get(999), undefined);
+				await lowPriorityDb.close();
+			});
+			it('adaptive batching with a commit latency budget', async function () {
+				let batchingDb = open(testDirPath + '/adaptive-batching.mdb', {
+					commitLatencyBudget: 20,
+					encryptionKey: options.encryptionKey,
+				});
+				let lastPromise;
+				for (let i = 0; i < 100; i++) {
+					for (let j = 0; j < 20; j++) lastPromise = batchingDb.put(i * 20 + j, 'value ' + j);
+					await new Promise((resolve) => setImmediate(resolve));
+				}
+				await lastPromise;
+				batchingDb.get(1999).should.equal('value 19');
+				batchingDb.getStats().commitLatency.should.be.gt(0);
+				await batchingDb.close();
+			});
+			it('commit through io_uring', async function () {
+				let ioUringDb = open(testDirPath + '/io-uring.mdb', {
+					ioUring: true,
+					overlappingSync: false,
+					encryptionKey: options.encryptionKey,
+				});
+				let value = 'x'.repeat(5000);
+				await ioUringDb.transaction(() => {
+					for (let i = 0; i < 1000; i++) ioUringDb.put(i, value + i);
+				});
+				await ioUringDb.close();
+				ioUringDb = open(testDirPath + '/io-uring.mdb', {
+					encryptionKey: options.encryptionKey,
+				});
+				for (let i = 0; i < 1000; i += 99)
+					ioUringDb.get(i).should.equal(value + i);
+				await ioUringDb.close();
+			});
 			it('use random access structures', async function () {
 				let dbRAS = db.openDB(
 					Object.assign({
@@ -1964,6 +2471,51 @@ describe('lmdb-js', function () {
 				i++;
 			}
 		});
+		it('search pages with evenly spread and skewed keys', async function () {
+			// the key search in each page interpolates uint32 keys, it should find the same positions with any spread
+			let spreads = {
+				even: (i) => i * 1000 + 10,
+				// a dense run of keys, followed by keys spread out to near the top of the uint32 range
+				skewed: (i) => (i < 8000 ? i : 8000 + (i - 7999) * 1900000),
+			};
+			for (let name in spreads) {
+				let searchDb = db.openDB('uint32-search-' + name, {
+					keyEncoding: 'uint32',
+				});
+				let keys = [];
+				let lastPromise;
+				for (let i = 0; i < 10000; i++) {
+					let key = spreads[name](i);
+					keys.push(key);
+					lastPromise = searchDb.put(key, 'value' + key);
+				}
+				await lastPromise;
+				should.equal(searchDb.get(0), name == 'skewed' ? 'value0' : undefined);
+				for (let i = 0; i < keys.length; i++) {
+					let key = keys[i];
+					searchDb.get(key).should.equal('value' + key);
+					let next = keys[i + 1];
+					let between = [];
+					if (next === undefined) between.push(key + 1);
+					else if (next > key + 1)
+						between.push(key + 1, Math.floor((key + next) / 2));
+					for (let start of between) {
+						should.equal(searchDb.get(start), undefined);
+						let first = Array.from(searchDb.getKeys({ start, limit: 1 }));
+						if (next === undefined) first.length.should.equal(0);
+						else first[0].should.equal(next);
+						let previous = Array.from(
+							searchDb.getKeys({ start, reverse: true, limit: 1 }),
+						);
+						previous[0].should.equal(key);
+					}
+				}
+				Array.from(searchDb.getKeys({ start: 0, limit: 1 }))[0].should.equal(
+					keys[0],
+				);
+				Array.from(searchDb.getKeys()).should.deep.equal(keys);
+			}
+		});
 		after(function () {
 			db.close();
 		});
@@ -65,6 +65,7 @@ export function addWriteMethods(
 		commitDelay,
 		separateFlushed,
 		maxFlushDelay,
+		lowPriorityBatchSize,
 	},
 ) {
 	//  stands for write instructions
@@ -118,9 +119,12 @@ export function addWriteMethods(
 		lastFlushTimeout,
 		lastFlushCallback;
 	var hasUnresolvedTxns;
+	var lowPriorityQueue = [],
+		lowPriorityPending;
 	txnStartThreshold = txnStartThreshold || 5;
 	batchStartThreshold = batchStartThreshold || 1000;
 	maxFlushDelay = maxFlushDelay || 500;
+	lowPriorityBatchSize = lowPriorityBatchSize || 1000;
 
 	allocateInstructionBuffer();
 	dynamicBytes.uint32[2] = TXN_DELIMITER | TXN_COMMITTED | TXN_FLUSHED;
@@ -300,12 +304,9 @@ export function addWriteMethods(
 				) {
 					flags |= 0x100000;
 					float64[position] = store.compression.address;
-					if (!writeTxn)
-						compress(env.address, uint32.address + (position << 3), () => {
-							// this is never actually called in NodeJS, just use to pin the buffer in memory until it is finished
-							// and is a no-op in Deno
-							if (!float64) throw new Error('No float64 available');
-						});
+					// queue it for the compression threads (if the queue is full, the write
+					// thread will compress it)
+					if (!writeTxn) compress(env.address, uint32.address + (position << 3));
 					position++;
 				}
 			}
@@ -722,6 +723,61 @@ export function addWriteMethods(
 			write(env.address, 0);
 		}
 	}
+	// Low priority writes are queued in their own lane, and are only written into the instruction stream
+	// (lowPriorityBatchSize at a time) once the previous chunk has committed, so that normal writes are never
+	// queued behind more than one chunk of a large low priority import
+	function queueLowPriority(flags, store, key, value, version, ifVersion, callback) {
+		let promise = new Promise((resolve) => {
+			lowPriorityQueue.push({
+				flags,
+				store,
+				key,
+				value,
+				version,
+				ifVersion,
+				callback,
+				resolve,
+			});
+		});
+		if (!lowPriorityPending)
+			lowPriorityPending = new Promise((resolve) => queueTask(resolve)).then(
+				writeLowPriority,
+			);
+		if (typeof callback == 'function') {
+			promise.then((result) => callback(null, result), callback);
+			return;
+		}
+		return promise;
+	}
+	function writeLowPriority() {
+		if (writeTxn)
+			// wait for the synchronous transaction to finish
+			return new Promise((resolve) => queueTask(resolve)).then(
+				writeLowPriority,
+			);
+		let writes = lowPriorityQueue.splice(0, lowPriorityBatchSize);
+		let lastPromise;
+		for (let write of writes) {
+			try {
+				lastPromise = writeInstructions(
+					write.flags,
+					write.store,
+					write.key,
+					write.value,
+					write.version,
+					write.ifVersion,
+				)(write.callback === IF_EXISTS ? IF_EXISTS : undefined);
+			} catch (error) {
+				lastPromise = Promise.reject(error);
+			}
+			write.resolve(lastPromise);
+		}
+		let next = () => {
+			if (lowPriorityQueue.length > 0) return writeLowPriority();
+			lowPriorityPending = null;
+		};
+		return lastPromise.then(next, next);
+	}
 	function clearWriteTxn(parentTxn) {
 		// TODO: We might actually want to track cursors in a write txn and manually
 		// close them.
@@ -732,8 +788,10 @@ export function addWriteMethods(
 		put(key, value, versionOrOptions, ifVersion) {
 			let callback,
 				flags = 15,
-				type = typeof versionOrOptions;
+				type = typeof versionOrOptions,
+				priority = this.writePriority;
 			if (type == 'object' && versionOrOptions) {
+				if (versionOrOptions.priority) priority = versionOrOptions.priority;
 				if (versionOrOptions.noOverwrite) flags |= 0x10;
 				if (versionOrOptions.noDupData) flags |= 0x20;
 				if (versionOrOptions.instructedWrite) flags |= 0x2000;
@@ -745,6 +803,17 @@ export function addWriteMethods(
 			} else if (type == 'function') {
 				callback = versionOrOptions;
 			}
+			// low priority writes in a batch or transaction are written with the rest of it
+			if (priority === 'low' && !writeTxn && batchDepth < 2)
+				return queueLowPriority(
+					flags,
+					this,
+					key,
+					value,
+					this.useVersions ? versionOrOptions || 0 : undefined,
+					ifVersion,
+					callback,
+				);
 			return writeInstructions(
 				flags,
 				this,
@@ -768,6 +837,16 @@ export function addWriteMethods(
 					value = ifVersionOrValue;
 				}
 			}
+			if (this.writePriority === 'low' && !writeTxn && batchDepth < 2)
+				return queueLowPriority(
+					flags,
+					this,
+					key,
+					value,
+					undefined,
+					ifVersion,
+					callback,
+				);
 			return writeInstructions(
 				flags,
 				this,
@@ -1069,6 +1148,11 @@ export function addWriteMethods(
 					() => {
 						throw new Error('Database is closed');
 					};
+			if (lowPriorityPending)
+				// write out the rest of the low priority lane first
+				return lowPriorityPending.then(() =>
+					this._endWrites(resolvedPromise, resolvedSyncPromise),
+				);
 			// wait for all txns to finish, checking again after the current txn is done
 			let finalPromise = flushPromise || commitPromise || lastWritePromise;
 			if (flushPromise) flushPromise.hasCallbacks = true;